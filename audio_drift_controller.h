@@ -0,0 +1,155 @@
+#ifndef RYUJINX_AUDIO_DRIFT_CONTROLLER_H
+#define RYUJINX_AUDIO_DRIFT_CONTROLLER_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace RyujinxOboe {
+
+// 根据缓冲区填充量计算重采样比例，补偿模拟时钟与设备时钟之间的漂移。
+// 启动后先观察 SETTLE_MS 得到自然的填充量作为目标，之后填充量高于目标时稍微加快消耗，
+// 低于目标时放慢，修正量限制在 MAX_CORRECTION_PPM 以内。
+// 只在回调线程里使用，不是线程安全的。
+class AudioDriftController {
+public:
+    static constexpr double MAX_CORRECTION_PPM = 500.0;
+    static constexpr int32_t SETTLE_MS = 1000;
+    static constexpr int32_t SMOOTHING_MS = 500;
+
+    void Reset(int32_t sample_rate) {
+        m_sample_rate = sample_rate > 0 ? sample_rate : 48000;
+        m_target_frames = -1.0;
+        m_settle_frames = 0;
+        m_settle_sum = 0.0;
+        m_smoothed_fill = 0.0;
+        m_integral = 0.0;
+        m_correction_ppm = 0.0;
+    }
+
+    // fill_frames 为本次回调读取前缓冲区里的帧数，返回每输出一帧消耗的输入帧数
+    double Update(int32_t fill_frames, int32_t elapsed_frames, bool starved) {
+        if (m_target_frames < 0.0) {
+            // 生产者还没开始写入时不计入观察时间
+            if (fill_frames == 0 && m_settle_frames == 0) {
+                return 1.0;
+            }
+
+            m_settle_sum += static_cast<double>(fill_frames) * elapsed_frames;
+            m_settle_frames += elapsed_frames;
+            if (m_settle_frames >= static_cast<int64_t>(m_sample_rate) * SETTLE_MS / 1000) {
+                m_target_frames = m_settle_sum / m_settle_frames;
+                m_smoothed_fill = m_target_frames;
+            }
+            return 1.0;
+        }
+
+        double seconds = static_cast<double>(elapsed_frames) / m_sample_rate;
+        double alpha = std::min(1.0, seconds * 1000.0 / SMOOTHING_MS);
+        m_smoothed_fill += (fill_frames - m_smoothed_fill) * alpha;
+
+        double error_ms = (m_smoothed_fill - m_target_frames) * 1000.0 / m_sample_rate;
+
+        // 欠载说明生产者跟不上，不是时钟漂移，不累积积分
+        if (!starved) {
+            m_integral = std::clamp(m_integral + error_ms * seconds,
+                                    -MAX_CORRECTION_PPM / KI_PPM, MAX_CORRECTION_PPM / KI_PPM);
+        }
+
+        double target_ppm = std::clamp(error_ms * KP_PPM + m_integral * KI_PPM,
+                                       -MAX_CORRECTION_PPM, MAX_CORRECTION_PPM);
+
+        // 限制比例的变化速度，避免可听见的音高抖动
+        double max_step = SLEW_PPM_PER_SECOND * seconds;
+        m_correction_ppm += std::clamp(target_ppm - m_correction_ppm, -max_step, max_step);
+
+        return 1.0 + m_correction_ppm * 1e-6;
+    }
+
+    double GetCorrectionPpm() const { return m_correction_ppm; }
+    // 观察期结束前返回 -1
+    int32_t GetTargetFrames() const { return static_cast<int32_t>(m_target_frames); }
+
+private:
+    // 每毫秒填充量偏差对应的比例修正量
+    static constexpr double KP_PPM = 20.0;
+    // 每毫秒·秒累积偏差对应的修正量，用于消除固定的时钟差
+    static constexpr double KI_PPM = 2.0;
+    static constexpr double SLEW_PPM_PER_SECOND = 200.0;
+
+    int32_t m_sample_rate = 48000;
+    double m_target_frames = -1.0;
+    int64_t m_settle_frames = 0;
+    double m_settle_sum = 0.0;
+    double m_smoothed_fill = 0.0;
+    double m_integral = 0.0;
+    double m_correction_ppm = 0.0;
+};
+
+// 不做修正时测量填充量的变化趋势，决定是否需要 AudioDriftController。
+// 时钟漂移让填充量线性增减，延迟调整和生产者卡顿只带来一次性的跳变，
+// 所以要求连续 DETECT_WINDOWS 个窗口之间的斜率同号并且超过 DETECT_PPM。
+// 只在回调线程里使用，不是线程安全的。
+class AudioDriftDetector {
+public:
+    static constexpr int32_t WINDOW_MS = 2000;
+    static constexpr int32_t DETECT_WINDOWS = 3;
+    static constexpr double DETECT_PPM = 50.0;
+
+    void Reset(int32_t sample_rate) {
+        m_window_length = static_cast<int64_t>(sample_rate > 0 ? sample_rate : 48000) * WINDOW_MS / 1000;
+        m_detected = false;
+        m_window_sum = 0.0;
+        m_window_frames = 0;
+        m_previous_mean = 0.0;
+        m_has_previous = false;
+        m_streak = 0;
+        m_streak_sign = 0;
+    }
+
+    // 参数与 AudioDriftController::Update 相同，测到持续漂移后一直返回 true
+    bool Update(int32_t fill_frames, int32_t elapsed_frames, bool starved) {
+        if (m_detected) {
+            return true;
+        }
+
+        // 欠载只说明生产者暂时迟到，补上之后填充量会回到原来的水平，跳过这些样本
+        if (starved) {
+            return false;
+        }
+
+        m_window_sum += static_cast<double>(fill_frames) * elapsed_frames;
+        m_window_frames += elapsed_frames;
+        if (m_window_frames < m_window_length) {
+            return false;
+        }
+
+        double mean = m_window_sum / m_window_frames;
+        if (m_has_previous) {
+            double ppm = (mean - m_previous_mean) / m_window_frames * 1e6;
+            int32_t sign = ppm >= DETECT_PPM ? 1 : (ppm <= -DETECT_PPM ? -1 : 0);
+            m_streak = sign != 0 && sign == m_streak_sign ? m_streak + 1 : (sign != 0 ? 1 : 0);
+            m_streak_sign = sign;
+            m_detected = m_streak >= DETECT_WINDOWS;
+        }
+
+        m_previous_mean = mean;
+        m_has_previous = true;
+        m_window_sum = 0.0;
+        m_window_frames = 0;
+        return m_detected;
+    }
+
+private:
+    int64_t m_window_length = 96000;
+    bool m_detected = false;
+    double m_window_sum = 0.0;
+    int64_t m_window_frames = 0;
+    double m_previous_mean = 0.0;
+    bool m_has_previous = false;
+    int32_t m_streak = 0;
+    int32_t m_streak_sign = 0;
+};
+
+} // namespace RyujinxOboe
+
+#endif // RYUJINX_AUDIO_DRIFT_CONTROLLER_H
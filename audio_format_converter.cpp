@@ -0,0 +1,313 @@
+#include "audio_format_converter.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace RyujinxOboe {
+
+namespace {
+
+// 与 Ryujinx.Audio 的 Downmixing 使用相同的系数
+constexpr float FRONT_GAIN = 1.0f;
+constexpr float CENTER_GAIN = 0.707f;
+constexpr float LFE_GAIN = 0.251f;
+constexpr float BACK_GAIN = 0.707f;
+constexpr float STEREO_TO_MONO_GAIN = 0.501f;
+
+constexpr float INT16_SCALE = 32768.0f;
+constexpr float INT24_SCALE = 8388608.0f;
+constexpr float INT32_SCALE = 2147483648.0f;
+
+void DecodeInt16(const int16_t* src, float* dst, size_t samples) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t scale = vdupq_n_f32(1.0f / INT16_SCALE);
+    for (; i + 8 <= samples; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dst + i, vmulq_f32(lo, scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(hi, scale));
+    }
+#endif
+    for (; i < samples; ++i) {
+        dst[i] = static_cast<float>(src[i]) * (1.0f / INT16_SCALE);
+    }
+}
+
+void DecodeInt24(const uint8_t* src, float* dst, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        const uint8_t* p = src + i * 3;
+        int32_t value = static_cast<int32_t>((static_cast<uint32_t>(p[2]) << 24) |
+                                             (static_cast<uint32_t>(p[1]) << 16) |
+                                             (static_cast<uint32_t>(p[0]) << 8)) >> 8;
+        dst[i] = static_cast<float>(value) * (1.0f / INT24_SCALE);
+    }
+}
+
+void DecodeInt32(const int32_t* src, float* dst, size_t samples) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t scale = vdupq_n_f32(1.0f / INT32_SCALE);
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+    }
+#endif
+    for (; i < samples; ++i) {
+        dst[i] = static_cast<float>(src[i]) * (1.0f / INT32_SCALE);
+    }
+}
+
+void EncodeInt16(const float* src, int16_t* dst, size_t samples) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t scale = vdupq_n_f32(INT16_SCALE);
+    for (; i + 8 <= samples; i += 8) {
+        // vcvtnq 和 vqmovn 都是饱和运算，不需要单独限幅
+        int32x4_t lo = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i), scale));
+        int32x4_t hi = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i + 4), scale));
+        vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+#endif
+    for (; i < samples; ++i) {
+        float value = std::nearbyint(src[i] * INT16_SCALE);
+        dst[i] = static_cast<int16_t>(std::clamp(value, -32768.0f, 32767.0f));
+    }
+}
+
+void EncodeInt24(const float* src, uint8_t* dst, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) {
+        float value = std::nearbyint(src[i] * INT24_SCALE);
+        int32_t sample = static_cast<int32_t>(std::clamp(value, -8388608.0f, 8388607.0f));
+        uint8_t* p = dst + i * 3;
+        p[0] = static_cast<uint8_t>(sample);
+        p[1] = static_cast<uint8_t>(sample >> 8);
+        p[2] = static_cast<uint8_t>(sample >> 16);
+    }
+}
+
+void EncodeInt32(const float* src, int32_t* dst, size_t samples) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t scale = vdupq_n_f32(INT32_SCALE);
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_s32(dst + i, vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i), scale)));
+    }
+#endif
+    for (; i < samples; ++i) {
+        double value = std::nearbyint(static_cast<double>(src[i]) * INT32_SCALE);
+        dst[i] = static_cast<int32_t>(std::clamp(value, -2147483648.0, 2147483647.0));
+    }
+}
+
+void DownmixSurroundToStereo(const float* src, float* dst, int32_t frames) {
+    int32_t i = 0;
+#if defined(__ARM_NEON)
+    // vld3q 以 3 个 float 为步长解交错，两帧 5.1 正好是 4 组：
+    // a.val[0] = {FL0, LFE0, FL1, LFE1}, a.val[1] = {FR0, BL0, FR1, BL1}, a.val[2] = {FC0, BR0, FC1, BR1}
+    const float l0[4] = {FRONT_GAIN, LFE_GAIN, FRONT_GAIN, LFE_GAIN};
+    const float l1[4] = {0.0f, BACK_GAIN, 0.0f, BACK_GAIN};
+    const float l2[4] = {CENTER_GAIN, 0.0f, CENTER_GAIN, 0.0f};
+    const float r0[4] = {0.0f, LFE_GAIN, 0.0f, LFE_GAIN};
+    const float r1[4] = {FRONT_GAIN, 0.0f, FRONT_GAIN, 0.0f};
+    const float r2[4] = {CENTER_GAIN, BACK_GAIN, CENTER_GAIN, BACK_GAIN};
+    const float32x4_t cl0 = vld1q_f32(l0), cl1 = vld1q_f32(l1), cl2 = vld1q_f32(l2);
+    const float32x4_t cr0 = vld1q_f32(r0), cr1 = vld1q_f32(r1), cr2 = vld1q_f32(r2);
+
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x3_t a = vld3q_f32(src + i * 6);
+        float32x4x3_t b = vld3q_f32(src + i * 6 + 12);
+
+        float32x4_t la = vfmaq_f32(vfmaq_f32(vmulq_f32(a.val[0], cl0), a.val[1], cl1), a.val[2], cl2);
+        float32x4_t lb = vfmaq_f32(vfmaq_f32(vmulq_f32(b.val[0], cl0), b.val[1], cl1), b.val[2], cl2);
+        float32x4_t ra = vfmaq_f32(vfmaq_f32(vmulq_f32(a.val[0], cr0), a.val[1], cr1), a.val[2], cr2);
+        float32x4_t rb = vfmaq_f32(vfmaq_f32(vmulq_f32(b.val[0], cr0), b.val[1], cr1), b.val[2], cr2);
+
+        float32x4x2_t out;
+        out.val[0] = vpaddq_f32(la, lb);
+        out.val[1] = vpaddq_f32(ra, rb);
+        vst2q_f32(dst + i * 2, out);
+    }
+#endif
+    for (; i < frames; ++i) {
+        const float* s = src + i * 6;
+        float common = s[2] * CENTER_GAIN + s[3] * LFE_GAIN;
+        dst[i * 2] = s[0] * FRONT_GAIN + common + s[4] * BACK_GAIN;
+        dst[i * 2 + 1] = s[1] * FRONT_GAIN + common + s[5] * BACK_GAIN;
+    }
+}
+
+void DownmixStereoToMono(const float* src, float* dst, int32_t frames) {
+    int32_t i = 0;
+#if defined(__ARM_NEON)
+    const float32x4_t gain = vdupq_n_f32(STEREO_TO_MONO_GAIN);
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t s = vld2q_f32(src + i * 2);
+        vst1q_f32(dst + i, vmulq_f32(vaddq_f32(s.val[0], s.val[1]), gain));
+    }
+#endif
+    for (; i < frames; ++i) {
+        dst[i] = (src[i * 2] + src[i * 2 + 1]) * STEREO_TO_MONO_GAIN;
+    }
+}
+
+void UpmixMonoToStereo(const float* src, float* dst, int32_t frames) {
+    int32_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t out;
+        out.val[0] = vld1q_f32(src + i);
+        out.val[1] = out.val[0];
+        vst2q_f32(dst + i * 2, out);
+    }
+#endif
+    for (; i < frames; ++i) {
+        dst[i * 2] = src[i];
+        dst[i * 2 + 1] = src[i];
+    }
+}
+
+// 其它组合：按声道序号对应复制，多出的声道静音
+void RemapChannels(const float* src, int32_t src_channels, float* dst, int32_t dst_channels, int32_t frames) {
+    int32_t common = std::min(src_channels, dst_channels);
+    for (int32_t i = 0; i < frames; ++i) {
+        const float* s = src + i * src_channels;
+        float* d = dst + i * dst_channels;
+        int32_t c = 0;
+        for (; c < common; ++c) {
+            d[c] = s[c];
+        }
+        for (; c < dst_channels; ++c) {
+            d[c] = 0.0f;
+        }
+    }
+}
+
+void ApplyGain(float* samples, int32_t frames, int32_t channels, float gain, float gain_step) {
+    if (gain_step == 0.0f) {
+        if (gain == 1.0f) return;
+
+        size_t count = static_cast<size_t>(frames) * channels;
+        size_t i = 0;
+#if defined(__ARM_NEON)
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+        }
+#endif
+        for (; i < count; ++i) {
+            samples[i] *= gain;
+        }
+        return;
+    }
+
+    int32_t i = 0;
+#if defined(__ARM_NEON)
+    if (channels == 2) {
+        // 每次处理两帧，增益向量为 {g0, g0, g1, g1}
+        const float lanes[4] = {0.0f, 0.0f, gain_step, gain_step};
+        float32x4_t g = vaddq_f32(vdupq_n_f32(gain), vld1q_f32(lanes));
+        const float32x4_t g_inc = vdupq_n_f32(gain_step * 2.0f);
+        for (; i + 2 <= frames; i += 2) {
+            vst1q_f32(samples + i * 2, vmulq_f32(vld1q_f32(samples + i * 2), g));
+            g = vaddq_f32(g, g_inc);
+        }
+    }
+#endif
+    for (; i < frames; ++i) {
+        float g = gain + gain_step * static_cast<float>(i);
+        float* frame = samples + static_cast<size_t>(i) * channels;
+        for (int32_t c = 0; c < channels; ++c) {
+            frame[c] *= g;
+        }
+    }
+}
+
+void Decode(const void* src, int32_t format, float* dst, size_t samples) {
+    switch (format) {
+        case PCM_INT16: DecodeInt16(static_cast<const int16_t*>(src), dst, samples); break;
+        case PCM_INT24: DecodeInt24(static_cast<const uint8_t*>(src), dst, samples); break;
+        case PCM_INT32: DecodeInt32(static_cast<const int32_t*>(src), dst, samples); break;
+        case PCM_FLOAT: std::memcpy(dst, src, samples * sizeof(float)); break;
+        default:        std::memset(dst, 0, samples * sizeof(float)); break;
+    }
+}
+
+void Encode(const float* src, int32_t format, void* dst, size_t samples) {
+    switch (format) {
+        case PCM_INT16: EncodeInt16(src, static_cast<int16_t*>(dst), samples); break;
+        case PCM_INT24: EncodeInt24(src, static_cast<uint8_t*>(dst), samples); break;
+        case PCM_INT32: EncodeInt32(src, static_cast<int32_t*>(dst), samples); break;
+        case PCM_FLOAT: std::memcpy(dst, src, samples * sizeof(float)); break;
+        default:        break;
+    }
+}
+
+} // namespace
+
+size_t AudioFormatConverter::GetBytesPerSample(int32_t format) {
+    switch (format) {
+        case PCM_INT16:  return 2;
+        case PCM_INT24:  return 3;
+        case PCM_INT32:  return 4;
+        case PCM_FLOAT:  return 4;
+        default:         return 2;
+    }
+}
+
+void AudioFormatConverter::Configure(int32_t src_format, int32_t src_channels, int32_t dst_format, int32_t dst_channels) {
+    m_src_format = src_format;
+    m_src_channels = std::clamp(src_channels, 1, MAX_CHANNELS);
+    m_dst_format = dst_format;
+    m_dst_channels = std::clamp(dst_channels, 1, MAX_CHANNELS);
+    m_src_frame_bytes = static_cast<int32_t>(m_src_channels * GetBytesPerSample(m_src_format));
+    m_dst_frame_bytes = static_cast<int32_t>(m_dst_channels * GetBytesPerSample(m_dst_format));
+}
+
+void AudioFormatConverter::Convert(const void* src, void* dst, int32_t num_frames, float gain, float gain_step) {
+    if (num_frames <= 0) return;
+
+    if (IsPassthrough() && gain == 1.0f && gain_step == 0.0f) {
+        std::memcpy(dst, src, static_cast<size_t>(num_frames) * m_src_frame_bytes);
+        return;
+    }
+
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    uint8_t* out = static_cast<uint8_t*>(dst);
+
+    while (num_frames > 0) {
+        int32_t frames = std::min(num_frames, CHUNK_FRAMES);
+
+        Decode(in, m_src_format, m_src_scratch, static_cast<size_t>(frames) * m_src_channels);
+
+        float* mixed = m_src_scratch;
+        if (m_src_channels != m_dst_channels) {
+            if (m_src_channels == 6 && m_dst_channels == 2) {
+                DownmixSurroundToStereo(m_src_scratch, m_dst_scratch, frames);
+            } else if (m_src_channels == 2 && m_dst_channels == 1) {
+                DownmixStereoToMono(m_src_scratch, m_dst_scratch, frames);
+            } else if (m_src_channels == 1 && m_dst_channels == 2) {
+                UpmixMonoToStereo(m_src_scratch, m_dst_scratch, frames);
+            } else {
+                // 2ch -> 6ch 只放到前左/前右
+                RemapChannels(m_src_scratch, m_src_channels, m_dst_scratch, m_dst_channels, frames);
+            }
+            mixed = m_dst_scratch;
+        }
+
+        // 增益与格式转换在同一次遍历中完成
+        ApplyGain(mixed, frames, m_dst_channels, gain, gain_step);
+        gain += gain_step * static_cast<float>(frames);
+
+        Encode(mixed, m_dst_format, out, static_cast<size_t>(frames) * m_dst_channels);
+
+        in += static_cast<size_t>(frames) * m_src_frame_bytes;
+        out += static_cast<size_t>(frames) * m_dst_frame_bytes;
+        num_frames -= frames;
+    }
+}
+
+} // namespace RyujinxOboe
@@ -0,0 +1,52 @@
+#ifndef RYUJINX_AUDIO_FORMAT_CONVERTER_H
+#define RYUJINX_AUDIO_FORMAT_CONVERTER_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace RyujinxOboe {
+
+enum SampleFormat {
+    PCM_INT16 = 1,
+    PCM_INT24 = 2,
+    PCM_INT32 = 3,
+    PCM_FLOAT = 4
+};
+
+// 把交错 PCM 从一种格式/声道数转换到另一种，中间统一使用 float。
+// 格式取值与 SampleFormat 相同。Convert 不分配内存，可以在回调线程中调用；
+// Configure 只能在没有并发 Convert 时调用。
+class AudioFormatConverter {
+public:
+    static constexpr int32_t MAX_CHANNELS = 8;
+    static constexpr int32_t CHUNK_FRAMES = 256;
+
+    void Configure(int32_t src_format, int32_t src_channels, int32_t dst_format, int32_t dst_channels);
+
+    bool IsPassthrough() const {
+        return m_src_format == m_dst_format && m_src_channels == m_dst_channels;
+    }
+
+    // gain 为第一帧的增益，之后每帧增加 gain_step，用于音量渐变
+    void Convert(const void* src, void* dst, int32_t num_frames, float gain = 1.0f, float gain_step = 0.0f);
+
+    int32_t GetSourceFrameBytes() const { return m_src_frame_bytes; }
+    int32_t GetDestinationFrameBytes() const { return m_dst_frame_bytes; }
+
+    static size_t GetBytesPerSample(int32_t format);
+
+private:
+    int32_t m_src_format = 0;
+    int32_t m_src_channels = 0;
+    int32_t m_dst_format = 0;
+    int32_t m_dst_channels = 0;
+    int32_t m_src_frame_bytes = 0;
+    int32_t m_dst_frame_bytes = 0;
+
+    alignas(16) float m_src_scratch[CHUNK_FRAMES * MAX_CHANNELS];
+    alignas(16) float m_dst_scratch[CHUNK_FRAMES * MAX_CHANNELS];
+};
+
+} // namespace RyujinxOboe
+
+#endif // RYUJINX_AUDIO_FORMAT_CONVERTER_H
@@ -0,0 +1,30 @@
+#ifndef RYUJINX_AUDIO_HOST_HOOKS_H
+#define RYUJINX_AUDIO_HOST_HOOKS_H
+
+#include <cstdint>
+
+// libryujinxjni（ryujinx.cpp）导出的接口。弱引用：渲染器链接到 libryujinxjni 时解析到那里的实现，
+// 单独构建（例如 bench）时为空指针，调用前必须检查。
+extern "C" {
+
+// 返回下一帧写入的音频被播放的 CLOCK_MONOTONIC 时间，与 getMonotonicTimeNs 同一时间基，0 表示未知
+typedef long (*AudioPresentationTimeProvider)(void* context);
+
+// 呈现端通过 getAudioPresentationTime 读取，同一时间只有一个提供者，后注册的替换先注册的
+__attribute__((weak)) void setAudioPresentationTimeProvider(AudioPresentationTimeProvider provider, void* context);
+// 只清除以 context 注册的提供者。返回后提供者不会再被调用
+__attribute__((weak)) void clearAudioPresentationTimeProvider(void* context);
+
+// 回调线程变化时（每次打开流后的第一次回调）调用，设置亲和性、调度优先级并创建性能提示会话，
+// target_duration_ns 为一次回调的时长
+__attribute__((weak)) void setAudioCallbackThread(int tid, long target_duration_ns);
+// 每次回调结束时报告实际耗时
+__attribute__((weak)) void reportAudioCallbackDuration(long duration_ns);
+
+// 转发给 Java 的事件，编号与 java_bridge.h 的 NativeEvent 一致，可以在任何线程调用且不会阻塞
+constexpr int NATIVE_EVENT_AUDIO_UNDERRUNS = 3;
+__attribute__((weak)) void postNativeEvent(int event, long value);
+
+}
+
+#endif // RYUJINX_AUDIO_HOST_HOOKS_H
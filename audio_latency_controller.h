@@ -0,0 +1,88 @@
+#ifndef RYUJINX_AUDIO_LATENCY_CONTROLLER_H
+#define RYUJINX_AUDIO_LATENCY_CONTROLLER_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace RyujinxOboe {
+
+// 根据 xrun 次数动态调整 AAudio 缓冲区大小：
+// 出现 xrun 时增加一个 burst，长时间稳定后再减少一个 burst。
+// 只在回调线程里使用，不是线程安全的。
+class AudioLatencyController {
+public:
+    static constexpr int32_t INITIAL_BURSTS = 2;
+    static constexpr int32_t MIN_BURSTS = 1;
+    static constexpr int32_t STABLE_PERIOD_MS = 5000;
+
+    void Reset(int32_t frames_per_burst, int32_t capacity_frames, int32_t sample_rate) {
+        m_frames_per_burst = frames_per_burst > 0 ? frames_per_burst : DEFAULT_BURST_FRAMES;
+        m_capacity_frames = capacity_frames > 0 ? capacity_frames : m_frames_per_burst * MAX_BURSTS;
+        m_stable_period_frames = static_cast<int64_t>(sample_rate > 0 ? sample_rate : 48000) * STABLE_PERIOD_MS / 1000;
+        m_target_frames = Clamp(m_frames_per_burst * INITIAL_BURSTS);
+        m_last_xrun_count = -1;
+        m_stable_frames = 0;
+    }
+
+    // elapsed_frames 为距离上一次调用经过的帧数，starved 表示这段时间里生产者没能及时供给数据。
+    // 返回新的目标缓冲区大小，不需要调整时返回 0。
+    int32_t Update(int32_t xrun_count, bool starved, int32_t elapsed_frames) {
+        if (m_last_xrun_count < 0) {
+            m_last_xrun_count = xrun_count;
+        }
+
+        if (xrun_count > m_last_xrun_count) {
+            m_last_xrun_count = xrun_count;
+            m_stable_frames = 0;
+            return Propose(m_target_frames + m_frames_per_burst);
+        }
+
+        // 生产者欠载与设备缓冲区大小无关，只是不算作稳定时间
+        if (starved) {
+            m_stable_frames = 0;
+            return 0;
+        }
+
+        m_stable_frames += elapsed_frames;
+        if (m_stable_frames >= m_stable_period_frames) {
+            m_stable_frames = 0;
+            return Propose(m_target_frames - m_frames_per_burst);
+        }
+
+        return 0;
+    }
+
+    // 记录 setBufferSizeInFrames 实际生效的大小
+    void OnBufferSizeApplied(int32_t actual_frames) {
+        if (actual_frames > 0) {
+            m_target_frames = actual_frames;
+        }
+    }
+
+    int32_t GetTargetFrames() const { return m_target_frames; }
+    int32_t GetFramesPerBurst() const { return m_frames_per_burst; }
+
+private:
+    static constexpr int32_t DEFAULT_BURST_FRAMES = 480;
+    static constexpr int32_t MAX_BURSTS = 8;
+
+    int32_t Clamp(int32_t frames) const {
+        return std::max(m_frames_per_burst * MIN_BURSTS, std::min(frames, m_capacity_frames));
+    }
+
+    int32_t Propose(int32_t frames) {
+        int32_t clamped = Clamp(frames);
+        return clamped != m_target_frames ? clamped : 0;
+    }
+
+    int32_t m_frames_per_burst = DEFAULT_BURST_FRAMES;
+    int32_t m_capacity_frames = DEFAULT_BURST_FRAMES * MAX_BURSTS;
+    int32_t m_target_frames = DEFAULT_BURST_FRAMES * INITIAL_BURSTS;
+    int32_t m_last_xrun_count = -1;
+    int64_t m_stable_frames = 0;
+    int64_t m_stable_period_frames = 48000 * STABLE_PERIOD_MS / 1000;
+};
+
+} // namespace RyujinxOboe
+
+#endif // RYUJINX_AUDIO_LATENCY_CONTROLLER_H
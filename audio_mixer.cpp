@@ -0,0 +1,285 @@
+#include "audio_mixer.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace RyujinxOboe {
+
+namespace {
+
+void Accumulate(float* dst, const float* src, size_t samples) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+    }
+#endif
+    for (; i < samples; ++i) {
+        dst[i] += src[i];
+    }
+}
+
+void AddToFloat(float* out, const float* mix, size_t samples, float gain) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_f32(out + i, vfmaq_n_f32(vld1q_f32(out + i), vld1q_f32(mix + i), gain));
+    }
+#endif
+    for (; i < samples; ++i) {
+        out[i] += mix[i] * gain;
+    }
+}
+
+void AddToInt16(int16_t* out, const float* mix, size_t samples, float gain) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    // 直接在整数域相加，vcvtnq 和 vqmovn 负责饱和
+    const float scale = gain * 32768.0f;
+    for (; i + 8 <= samples; i += 8) {
+        int16x8_t s = vld1q_s16(out + i);
+        float32x4_t lo = vfmaq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), vld1q_f32(mix + i), scale);
+        float32x4_t hi = vfmaq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), vld1q_f32(mix + i + 4), scale);
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)), vqmovn_s32(vcvtnq_s32_f32(hi))));
+    }
+#endif
+    for (; i < samples; ++i) {
+        float value = std::nearbyint(static_cast<float>(out[i]) + mix[i] * gain * 32768.0f);
+        out[i] = static_cast<int16_t>(std::clamp(value, -32768.0f, 32767.0f));
+    }
+}
+
+void AddToInt32(int32_t* out, const float* mix, size_t samples, float gain) {
+    for (size_t i = 0; i < samples; ++i) {
+        double value = std::nearbyint(static_cast<double>(out[i]) + static_cast<double>(mix[i] * gain) * 2147483648.0);
+        out[i] = static_cast<int32_t>(std::clamp(value, -2147483648.0, 2147483647.0));
+    }
+}
+
+void AddToInt24(uint8_t* out, const float* mix, size_t samples, float gain) {
+    for (size_t i = 0; i < samples; ++i) {
+        uint8_t* p = out + i * 3;
+        int32_t sample = static_cast<int32_t>((static_cast<uint32_t>(p[2]) << 24) |
+                                              (static_cast<uint32_t>(p[1]) << 16) |
+                                              (static_cast<uint32_t>(p[0]) << 8)) >> 8;
+        float value = std::nearbyint(static_cast<float>(sample) + mix[i] * gain * 8388608.0f);
+        sample = static_cast<int32_t>(std::clamp(value, -8388608.0f, 8388607.0f));
+        p[0] = static_cast<uint8_t>(sample);
+        p[1] = static_cast<uint8_t>(sample >> 8);
+        p[2] = static_cast<uint8_t>(sample >> 16);
+    }
+}
+
+void AddToOutput(void* out, int32_t format, const float* mix, size_t samples, float gain) {
+    switch (format) {
+        case PCM_INT16: AddToInt16(static_cast<int16_t*>(out), mix, samples, gain); break;
+        case PCM_INT24: AddToInt24(static_cast<uint8_t*>(out), mix, samples, gain); break;
+        case PCM_INT32: AddToInt32(static_cast<int32_t*>(out), mix, samples, gain); break;
+        case PCM_FLOAT: AddToFloat(static_cast<float*>(out), mix, samples, gain); break;
+        default:        break;
+    }
+}
+
+} // namespace
+
+void AudioMixer::SetOutputChannels(int32_t channels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_output_channels = std::clamp(channels, 1, MAX_CHANNELS);
+    for (auto& input : m_inputs) {
+        if (input.active.load()) {
+            input.converter.Configure(input.sample_format, input.channels, PCM_FLOAT, m_output_channels);
+        }
+    }
+}
+
+void AudioMixer::SetSampleRate(int32_t sample_rate) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_gain_ramp_frames = std::max(1.0f, sample_rate * GAIN_RAMP_MS / 1000.0f);
+}
+
+int32_t AudioMixer::OpenInput(int32_t channels, int32_t sample_format, uint32_t capacity_frames) {
+    if (channels < 1 || channels > MAX_CHANNELS) return -1;
+    if (sample_format < PCM_INT16 || sample_format > PCM_FLOAT) return -1;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (int32_t id = 0; id < MAX_INPUTS; ++id) {
+        Input& input = m_inputs[id];
+        if (input.active.load()) {
+            continue;
+        }
+
+        uint32_t frame_bytes = static_cast<uint32_t>(channels * AudioFormatConverter::GetBytesPerSample(sample_format));
+        if (!input.ring.Allocate(capacity_frames, frame_bytes)) {
+            return -1;
+        }
+
+        input.channels = channels;
+        input.sample_format = sample_format;
+        input.volume.store(1.0f);
+        input.current_gain = 1.0f;
+        input.converter.Configure(sample_format, channels, PCM_FLOAT, m_output_channels);
+
+        input.active.store(true, std::memory_order_release);
+        m_active_count.fetch_add(1, std::memory_order_release);
+        return id;
+    }
+
+    return -1;
+}
+
+void AudioMixer::CloseInput(int32_t input_id) {
+    if (!IsValid(input_id)) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Input& input = m_inputs[input_id];
+    if (!input.active.exchange(false)) {
+        return;
+    }
+    m_active_count.fetch_sub(1, std::memory_order_release);
+
+    // 等回调读完、生产者写完这个输入后才能释放或复用缓冲区
+    WaitForCallback();
+    while (input.writing.load()) {
+        std::this_thread::yield();
+    }
+    input.ring.Release();
+}
+
+void AudioMixer::CloseAllInputs() {
+    for (int32_t id = 0; id < MAX_INPUTS; ++id) {
+        CloseInput(id);
+    }
+}
+
+void AudioMixer::WaitForCallback() {
+    // 与 MixInto 之间是 Dekker 式的同步，需要顺序一致的内存序
+    uint32_t sequence = m_mix_sequence.load();
+    if ((sequence & 1) == 0) {
+        return;
+    }
+
+    while (m_mix_sequence.load(std::memory_order_acquire) == sequence) {
+        std::this_thread::yield();
+    }
+}
+
+bool AudioMixer::Write(int32_t input_id, const void* data, int32_t num_frames) {
+    if (!IsValid(input_id) || !data || num_frames <= 0) return false;
+
+    Input& input = m_inputs[input_id];
+
+    // 先公布正在写入再检查 active，与 CloseInput 的先清 active 再等 writing 构成 Dekker 式同步，
+    // 两边都需要顺序一致的内存序：要么这里看到输入已关闭，要么 CloseInput 等到写入结束
+    input.writing.store(true);
+    if (!input.active.load()) {
+        input.writing.store(false, std::memory_order_release);
+        return false;
+    }
+
+    bool written = input.ring.Write(data, static_cast<uint32_t>(num_frames)) == static_cast<uint32_t>(num_frames);
+    input.writing.store(false, std::memory_order_release);
+    return written;
+}
+
+void AudioMixer::SetInputVolume(int32_t input_id, float volume) {
+    if (!IsValid(input_id)) return;
+    m_inputs[input_id].volume.store(std::clamp(volume, 0.0f, 1.0f));
+}
+
+int32_t AudioMixer::GetBufferedFrames(int32_t input_id) const {
+    if (!IsValid(input_id) || !m_inputs[input_id].active.load()) return 0;
+    return static_cast<int32_t>(m_inputs[input_id].ring.AvailableToRead());
+}
+
+int32_t AudioMixer::GetFrameBytes(int32_t input_id) const {
+    if (!IsValid(input_id) || !m_inputs[input_id].active.load()) return 0;
+    return static_cast<int32_t>(m_inputs[input_id].ring.GetBytesPerFrame());
+}
+
+int32_t AudioMixer::MixInput(Input& input, int32_t num_frames) {
+    // 每个输入单独做音量渐变，满幅变化需要 GAIN_RAMP_MS
+    float target = input.volume.load(std::memory_order_relaxed);
+    float gain = input.current_gain;
+    float max_delta = static_cast<float>(num_frames) / m_gain_ramp_frames;
+    float delta = std::clamp(target - gain, -max_delta, max_delta);
+    float gain_step = delta / static_cast<float>(num_frames);
+
+    int32_t frames_done = 0;
+    while (frames_done < num_frames) {
+        const void* region = nullptr;
+        uint32_t frames = input.ring.AcquireRead(&region, static_cast<uint32_t>(num_frames - frames_done));
+        if (frames == 0) {
+            break;
+        }
+
+        input.converter.Convert(region, m_input_scratch + frames_done * m_output_channels, static_cast<int32_t>(frames),
+                                gain + gain_step * frames_done, gain_step);
+        input.ring.CommitRead(frames);
+        frames_done += static_cast<int32_t>(frames);
+    }
+
+    if (frames_done > 0) {
+        input.current_gain = std::abs(target - (gain + delta)) < 1e-6f ? target : gain + delta;
+        Accumulate(m_mix, m_input_scratch, static_cast<size_t>(frames_done) * m_output_channels);
+    }
+
+    return frames_done;
+}
+
+int32_t AudioMixer::MixInto(void* output, int32_t output_format, int32_t num_frames, float gain, float gain_step) {
+    m_mix_sequence.fetch_add(1);
+
+    uint8_t* out = static_cast<uint8_t*>(output);
+    const int32_t channels = m_output_channels;
+    const size_t frame_bytes = channels * AudioFormatConverter::GetBytesPerSample(output_format);
+    int32_t inputs_mixed = 0;
+
+    for (int32_t offset = 0; offset < num_frames; offset += CHUNK_FRAMES) {
+        int32_t frames = std::min(num_frames - offset, CHUNK_FRAMES);
+        int32_t mixed_frames = 0;
+        int32_t inputs_with_data = 0;
+
+        std::memset(m_mix, 0, sizeof(float) * frames * channels);
+        for (auto& input : m_inputs) {
+            if (!input.active.load()) {
+                continue;
+            }
+
+            int32_t frames_read = MixInput(input, frames);
+            if (frames_read > 0) {
+                mixed_frames = std::max(mixed_frames, frames_read);
+                ++inputs_with_data;
+            }
+        }
+
+        if (mixed_frames == 0) {
+            continue;
+        }
+        inputs_mixed = std::max(inputs_mixed, inputs_with_data);
+
+        float chunk_gain = gain + gain_step * offset;
+        uint8_t* chunk_out = out + offset * frame_bytes;
+        if (gain_step == 0.0f) {
+            AddToOutput(chunk_out, output_format, m_mix, static_cast<size_t>(mixed_frames) * channels, chunk_gain);
+        } else {
+            // 主音量渐变期间逐帧叠加
+            for (int32_t i = 0; i < mixed_frames; ++i) {
+                AddToOutput(chunk_out + i * frame_bytes, output_format, m_mix + i * channels, channels,
+                            chunk_gain + gain_step * i);
+            }
+        }
+    }
+
+    m_mix_sequence.fetch_add(1, std::memory_order_release);
+    return inputs_mixed;
+}
+
+} // namespace RyujinxOboe
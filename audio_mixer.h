@@ -0,0 +1,83 @@
+#ifndef RYUJINX_AUDIO_MIXER_H
+#define RYUJINX_AUDIO_MIXER_H
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include "audio_ring_buffer.h"
+#include "audio_format_converter.h"
+
+namespace RyujinxOboe {
+
+// 把多个输入混到同一个输出流里，每个输入有自己的环形缓冲区、格式和音量。
+// 所有输入的采样率必须与输出一致。每个输入只能有一个生产者线程，
+// MixInto 只能在回调线程调用；OpenInput/CloseInput 可以在任意线程调用。
+class AudioMixer {
+public:
+    static constexpr int32_t MAX_INPUTS = 8;
+    static constexpr int32_t CHUNK_FRAMES = AudioFormatConverter::CHUNK_FRAMES;
+    static constexpr int32_t MAX_CHANNELS = AudioFormatConverter::MAX_CHANNELS;
+
+    AudioMixer() = default;
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    // 输出声道数变化时重新配置所有输入，只能在回调停止时调用
+    void SetOutputChannels(int32_t channels);
+    // 输出采样率决定音量渐变的长度，只能在回调停止时调用
+    void SetSampleRate(int32_t sample_rate);
+
+    // 返回输入编号，没有空闲位置或参数无效时返回 -1
+    int32_t OpenInput(int32_t channels, int32_t sample_format, uint32_t capacity_frames);
+    void CloseInput(int32_t input_id);
+    void CloseAllInputs();
+
+    // 缓冲区满时丢弃剩余数据并返回 false，不会阻塞
+    bool Write(int32_t input_id, const void* data, int32_t num_frames);
+    void SetInputVolume(int32_t input_id, float volume);
+    int32_t GetBufferedFrames(int32_t input_id) const;
+    // 输入未打开时返回 0
+    int32_t GetFrameBytes(int32_t input_id) const;
+
+    bool HasActiveInputs() const { return m_active_count.load(std::memory_order_acquire) > 0; }
+
+    // 把所有输入叠加到 output 上，output 的格式为 output_format、声道数为 SetOutputChannels 设置的值。
+    // gain/gain_step 为主音量渐变，作用于所有输入的总和。返回有数据的输入个数。
+    int32_t MixInto(void* output, int32_t output_format, int32_t num_frames, float gain, float gain_step);
+
+private:
+    struct Input {
+        std::atomic<bool> active{false};
+        // 生产者正在写入缓冲区，CloseInput 等它清零后才释放缓冲区
+        std::atomic<bool> writing{false};
+        int32_t channels = 0;
+        int32_t sample_format = 0;
+        std::atomic<float> volume{1.0f};
+        // 只在回调线程中修改
+        float current_gain = 1.0f;
+        AudioRingBuffer ring;
+        AudioFormatConverter converter;
+    };
+
+    bool IsValid(int32_t input_id) const { return input_id >= 0 && input_id < MAX_INPUTS; }
+    int32_t MixInput(Input& input, int32_t num_frames);
+    void WaitForCallback();
+
+    static constexpr int32_t GAIN_RAMP_MS = 10;
+
+    Input m_inputs[MAX_INPUTS];
+    std::mutex m_mutex;
+    std::atomic<int32_t> m_active_count{0};
+    int32_t m_output_channels = 2;
+    float m_gain_ramp_frames = 480.0f;
+
+    // MixInto 进入时加 1、退出时再加 1，奇数表示回调正在读取输入
+    std::atomic<uint32_t> m_mix_sequence{0};
+
+    alignas(16) float m_mix[CHUNK_FRAMES * MAX_CHANNELS];
+    alignas(16) float m_input_scratch[CHUNK_FRAMES * MAX_CHANNELS];
+};
+
+} // namespace RyujinxOboe
+
+#endif // RYUJINX_AUDIO_MIXER_H
@@ -0,0 +1,130 @@
+#include "audio_resampler.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace RyujinxOboe {
+
+namespace {
+
+// Catmull-Rom 权重，对应 x[-1], x[0], x[1], x[2]
+inline void CubicWeights(float t, float w[4]) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+    w[0] = -0.5f * t + t2 - 0.5f * t3;
+    w[1] = 1.0f - 2.5f * t2 + 1.5f * t3;
+    w[2] = 0.5f * t + 2.0f * t2 - 1.5f * t3;
+    w[3] = -0.5f * t2 + 0.5f * t3;
+}
+
+inline void InterpolateFrame(const float* x, int32_t channels, const float w[4], float* out) {
+    // x 指向 x[-1] 所在的帧
+    int32_t c = 0;
+#if defined(__ARM_NEON)
+    for (; c + 4 <= channels; c += 4) {
+        float32x4_t y = vmulq_n_f32(vld1q_f32(x + c), w[0]);
+        y = vfmaq_n_f32(y, vld1q_f32(x + channels + c), w[1]);
+        y = vfmaq_n_f32(y, vld1q_f32(x + channels * 2 + c), w[2]);
+        y = vfmaq_n_f32(y, vld1q_f32(x + channels * 3 + c), w[3]);
+        vst1q_f32(out + c, y);
+    }
+#endif
+    for (; c < channels; ++c) {
+        out[c] = x[c] * w[0] + x[channels + c] * w[1] + x[channels * 2 + c] * w[2] + x[channels * 3 + c] * w[3];
+    }
+}
+
+} // namespace
+
+void AudioResampler::Configure(int32_t channels) {
+    m_channels = std::clamp(channels, 1, MAX_CHANNELS);
+    Reset();
+}
+
+void AudioResampler::Reset() {
+    std::memset(m_input, 0, sizeof(float) * HISTORY_FRAMES * m_channels);
+    m_position = 1.0;
+    m_buffered_frames = HISTORY_FRAMES;
+}
+
+int32_t AudioResampler::GetInputFramesNeeded(int32_t output_frames, double ratio) const {
+    if (output_frames <= 0) return 0;
+
+    output_frames = std::min(output_frames, MAX_OUTPUT_FRAMES);
+    ratio = std::clamp(ratio, MIN_RATIO, MAX_RATIO);
+
+    // 最后一个输出帧需要 floor(pos) + 2 处的输入
+    double last = m_position + ratio * (output_frames - 1);
+    int32_t needed = static_cast<int32_t>(std::floor(last)) + 3 - m_buffered_frames;
+    return std::clamp(needed, 0, BUFFER_FRAMES - m_buffered_frames);
+}
+
+int32_t AudioResampler::Process(int32_t input_frames, float* output, int32_t output_frames, double ratio) {
+    input_frames = std::clamp(input_frames, 0, BUFFER_FRAMES - m_buffered_frames);
+    output_frames = std::clamp(output_frames, 0, MAX_OUTPUT_FRAMES);
+    ratio = std::clamp(ratio, MIN_RATIO, MAX_RATIO);
+
+    const int32_t channels = m_channels;
+    const int32_t total = m_buffered_frames + input_frames;
+    double position = m_position;
+    int32_t produced = 0;
+
+#if defined(__ARM_NEON)
+    if (channels == 2) {
+        // 立体声每次处理两帧，{L0, R0, L1, R1} 放在同一个向量里
+        while (produced + 2 <= output_frames) {
+            double next = position + ratio;
+            int32_t i0 = static_cast<int32_t>(position);
+            int32_t i1 = static_cast<int32_t>(next);
+            if (i1 + 2 >= total) break;
+
+            float w0[4], w1[4];
+            CubicWeights(static_cast<float>(position - i0), w0);
+            CubicWeights(static_cast<float>(next - i1), w1);
+
+            const float* a = m_input + (i0 - 1) * 2;
+            const float* b = m_input + (i1 - 1) * 2;
+            float32x4_t y = vmulq_f32(vcombine_f32(vld1_f32(a), vld1_f32(b)),
+                                      vcombine_f32(vdup_n_f32(w0[0]), vdup_n_f32(w1[0])));
+            y = vfmaq_f32(y, vcombine_f32(vld1_f32(a + 2), vld1_f32(b + 2)),
+                          vcombine_f32(vdup_n_f32(w0[1]), vdup_n_f32(w1[1])));
+            y = vfmaq_f32(y, vcombine_f32(vld1_f32(a + 4), vld1_f32(b + 4)),
+                          vcombine_f32(vdup_n_f32(w0[2]), vdup_n_f32(w1[2])));
+            y = vfmaq_f32(y, vcombine_f32(vld1_f32(a + 6), vld1_f32(b + 6)),
+                          vcombine_f32(vdup_n_f32(w0[3]), vdup_n_f32(w1[3])));
+            vst1q_f32(output + produced * 2, y);
+
+            position = next + ratio;
+            produced += 2;
+        }
+    }
+#endif
+    while (produced < output_frames) {
+        int32_t i = static_cast<int32_t>(position);
+        if (i + 2 >= total) break;
+
+        float w[4];
+        CubicWeights(static_cast<float>(position - i), w);
+        InterpolateFrame(m_input + (i - 1) * channels, channels, w, output + produced * channels);
+
+        position += ratio;
+        ++produced;
+    }
+
+    // 丢弃下一个输出帧之前不再需要的输入，至少保留 HISTORY_FRAMES 帧
+    int32_t shift = std::clamp(static_cast<int32_t>(position) - 1, 0, total - HISTORY_FRAMES);
+    if (shift > 0) {
+        std::memmove(m_input, m_input + shift * channels, sizeof(float) * (total - shift) * channels);
+        position -= shift;
+    }
+    m_position = position;
+    m_buffered_frames = total - shift;
+
+    return produced;
+}
+
+} // namespace RyujinxOboe
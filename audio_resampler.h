@@ -0,0 +1,49 @@
+#ifndef RYUJINX_AUDIO_RESAMPLER_H
+#define RYUJINX_AUDIO_RESAMPLER_H
+
+#include <cstdint>
+
+namespace RyujinxOboe {
+
+// 比例可以随时变化的 4 点三次插值（Catmull-Rom）重采样器，只处理交错 float。
+// 用于把输入速率微调几百 ppm，不适合大比例的采样率转换。
+// 只在回调线程里使用，不是线程安全的。
+class AudioResampler {
+public:
+    static constexpr int32_t MAX_CHANNELS = 8;
+    static constexpr int32_t MAX_OUTPUT_FRAMES = 256;
+    static constexpr double MAX_RATIO = 1.01;
+    static constexpr double MIN_RATIO = 0.99;
+
+    void Configure(int32_t channels);
+    void Reset();
+
+    // ratio 为每输出一帧消耗的输入帧数，返回生成 output_frames 帧所需的输入帧数
+    int32_t GetInputFramesNeeded(int32_t output_frames, double ratio) const;
+
+    // 输入数据写到这里，最多写 GetInputFramesNeeded 返回的帧数
+    float* GetInputBuffer() { return m_input + m_buffered_frames * m_channels; }
+
+    // 消耗 input_frames 帧输入，返回实际生成的输出帧数。
+    // 输入不足时生成的帧数会少于 output_frames。
+    int32_t Process(int32_t input_frames, float* output, int32_t output_frames, double ratio);
+
+    int32_t GetChannelCount() const { return m_channels; }
+
+private:
+    // 插值需要当前位置之前 1 帧和之后 2 帧
+    static constexpr int32_t HISTORY_FRAMES = 3;
+    static constexpr int32_t BUFFER_FRAMES = static_cast<int32_t>(MAX_OUTPUT_FRAMES * MAX_RATIO) + HISTORY_FRAMES * 2 + 2;
+
+    int32_t m_channels = 2;
+    // 下一个输出帧在 m_input 中的位置，整数部分至少为 1
+    double m_position = 1.0;
+    // m_input 中还会用到的帧数，至少为 HISTORY_FRAMES
+    int32_t m_buffered_frames = HISTORY_FRAMES;
+
+    alignas(16) float m_input[BUFFER_FRAMES * MAX_CHANNELS];
+};
+
+} // namespace RyujinxOboe
+
+#endif // RYUJINX_AUDIO_RESAMPLER_H
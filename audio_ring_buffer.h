@@ -0,0 +1,206 @@
+#ifndef RYUJINX_AUDIO_RING_BUFFER_H
+#define RYUJINX_AUDIO_RING_BUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace RyujinxOboe {
+
+// 单生产者/单消费者的连续字节环形缓冲区。
+// 容量按帧计算并向上取 2 的幂，环绕点总是落在帧边界上，
+// 因此每次读写最多两次 memcpy。
+class AudioRingBuffer {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    AudioRingBuffer() = default;
+    AudioRingBuffer(const AudioRingBuffer&) = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    // 不是线程安全的，只能在回调停止时调用
+    bool Allocate(uint32_t min_frames, uint32_t bytes_per_frame) {
+        if (min_frames == 0 || bytes_per_frame == 0) return false;
+
+        uint32_t capacity = 1;
+        while (capacity < min_frames) {
+            capacity <<= 1;
+        }
+
+        if (capacity != m_capacity_frames || bytes_per_frame != m_bytes_per_frame) {
+            m_storage.reset(new (std::nothrow) uint8_t[static_cast<size_t>(capacity) * bytes_per_frame]);
+            if (!m_storage) {
+                m_capacity_frames = 0;
+                m_bytes_per_frame = 0;
+                return false;
+            }
+            m_capacity_frames = capacity;
+            m_bytes_per_frame = bytes_per_frame;
+        }
+
+        Clear();
+        return true;
+    }
+
+    void Release() {
+        m_storage.reset();
+        m_capacity_frames = 0;
+        m_bytes_per_frame = 0;
+        Clear();
+    }
+
+    // 不是线程安全的，只能在回调停止时调用
+    void Clear() {
+        m_write_index.store(0, std::memory_order_relaxed);
+        m_read_index.store(0, std::memory_order_relaxed);
+        m_cached_read_index = 0;
+        m_cached_write_index = 0;
+    }
+
+    // 生产者线程调用，返回实际写入的帧数
+    uint32_t Write(const void* data, uint32_t frames) {
+        if (!m_storage) return 0;
+
+        uint64_t write_index = m_write_index.load(std::memory_order_relaxed);
+        uint32_t free_frames = m_capacity_frames - static_cast<uint32_t>(write_index - m_cached_read_index);
+        if (free_frames < frames) {
+            m_cached_read_index = m_read_index.load(std::memory_order_acquire);
+            free_frames = m_capacity_frames - static_cast<uint32_t>(write_index - m_cached_read_index);
+        }
+
+        uint32_t to_write = std::min(frames, free_frames);
+        if (to_write == 0) return 0;
+
+        uint32_t offset = static_cast<uint32_t>(write_index) & (m_capacity_frames - 1);
+        uint32_t first = std::min(to_write, m_capacity_frames - offset);
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+
+        std::memcpy(FramePtr(offset), src, static_cast<size_t>(first) * m_bytes_per_frame);
+        if (first < to_write) {
+            std::memcpy(FramePtr(0), src + static_cast<size_t>(first) * m_bytes_per_frame,
+                        static_cast<size_t>(to_write - first) * m_bytes_per_frame);
+        }
+
+        m_write_index.store(write_index + to_write, std::memory_order_release);
+        return to_write;
+    }
+
+    // 生产者线程调用，返回一段连续可写区域，不会跨越环绕点。
+    // 写完后调用 CommitWrite 发布，之前数据对消费者不可见。
+    uint32_t AcquireWrite(void** region, uint32_t max_frames) {
+        *region = nullptr;
+        if (!m_storage) return 0;
+
+        uint64_t write_index = m_write_index.load(std::memory_order_relaxed);
+        uint32_t free_frames = m_capacity_frames - static_cast<uint32_t>(write_index - m_cached_read_index);
+        if (free_frames < max_frames) {
+            m_cached_read_index = m_read_index.load(std::memory_order_acquire);
+            free_frames = m_capacity_frames - static_cast<uint32_t>(write_index - m_cached_read_index);
+        }
+
+        uint32_t offset = static_cast<uint32_t>(write_index) & (m_capacity_frames - 1);
+        uint32_t frames = std::min({max_frames, free_frames, m_capacity_frames - offset});
+        if (frames == 0) return 0;
+
+        *region = FramePtr(offset);
+        return frames;
+    }
+
+    // frames 不能超过上一次 AcquireWrite 返回的帧数
+    void CommitWrite(uint32_t frames) {
+        uint64_t write_index = m_write_index.load(std::memory_order_relaxed);
+        m_write_index.store(write_index + frames, std::memory_order_release);
+    }
+
+    // 消费者线程调用，返回实际读取的帧数
+    uint32_t Read(void* data, uint32_t frames) {
+        if (!m_storage) return 0;
+
+        uint64_t read_index = m_read_index.load(std::memory_order_relaxed);
+        uint32_t ready_frames = static_cast<uint32_t>(m_cached_write_index - read_index);
+        if (ready_frames < frames) {
+            m_cached_write_index = m_write_index.load(std::memory_order_acquire);
+            ready_frames = static_cast<uint32_t>(m_cached_write_index - read_index);
+        }
+
+        uint32_t to_read = std::min(frames, ready_frames);
+        if (to_read == 0) return 0;
+
+        uint32_t offset = static_cast<uint32_t>(read_index) & (m_capacity_frames - 1);
+        uint32_t first = std::min(to_read, m_capacity_frames - offset);
+        uint8_t* dst = static_cast<uint8_t*>(data);
+
+        std::memcpy(dst, FramePtr(offset), static_cast<size_t>(first) * m_bytes_per_frame);
+        if (first < to_read) {
+            std::memcpy(dst + static_cast<size_t>(first) * m_bytes_per_frame, FramePtr(0),
+                        static_cast<size_t>(to_read - first) * m_bytes_per_frame);
+        }
+
+        m_read_index.store(read_index + to_read, std::memory_order_release);
+        return to_read;
+    }
+
+    // 消费者线程调用，返回一段连续可读区域，不会跨越环绕点。
+    // 处理完后调用 CommitRead 归还空间。
+    uint32_t AcquireRead(const void** region, uint32_t max_frames) {
+        *region = nullptr;
+        if (!m_storage) return 0;
+
+        uint64_t read_index = m_read_index.load(std::memory_order_relaxed);
+        uint32_t ready_frames = static_cast<uint32_t>(m_cached_write_index - read_index);
+        if (ready_frames < max_frames) {
+            m_cached_write_index = m_write_index.load(std::memory_order_acquire);
+            ready_frames = static_cast<uint32_t>(m_cached_write_index - read_index);
+        }
+
+        uint32_t offset = static_cast<uint32_t>(read_index) & (m_capacity_frames - 1);
+        uint32_t frames = std::min({max_frames, ready_frames, m_capacity_frames - offset});
+        if (frames == 0) return 0;
+
+        *region = FramePtr(offset);
+        return frames;
+    }
+
+    // frames 不能超过上一次 AcquireRead 返回的帧数
+    void CommitRead(uint32_t frames) {
+        uint64_t read_index = m_read_index.load(std::memory_order_relaxed);
+        m_read_index.store(read_index + frames, std::memory_order_release);
+    }
+
+    uint32_t AvailableToRead() const {
+        uint64_t write_index = m_write_index.load(std::memory_order_acquire);
+        uint64_t read_index = m_read_index.load(std::memory_order_acquire);
+        return static_cast<uint32_t>(write_index - read_index);
+    }
+
+    uint32_t AvailableToWrite() const {
+        return m_capacity_frames - AvailableToRead();
+    }
+
+    uint32_t GetCapacityFrames() const { return m_capacity_frames; }
+    uint32_t GetBytesPerFrame() const { return m_bytes_per_frame; }
+
+private:
+    uint8_t* FramePtr(uint32_t frame) const {
+        return m_storage.get() + static_cast<size_t>(frame) * m_bytes_per_frame;
+    }
+
+    std::unique_ptr<uint8_t[]> m_storage;
+    uint32_t m_capacity_frames = 0;
+    uint32_t m_bytes_per_frame = 0;
+
+    // 生产者独占
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_write_index{0};
+    uint64_t m_cached_read_index = 0;
+
+    // 消费者独占
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_read_index{0};
+    uint64_t m_cached_write_index = 0;
+};
+
+} // namespace RyujinxOboe
+
+#endif // RYUJINX_AUDIO_RING_BUFFER_H
@@ -0,0 +1,38 @@
+#ifndef RYUJINX_AUDIO_TRACE_H
+#define RYUJINX_AUDIO_TRACE_H
+
+// Perfetto/systrace 埋点。只有定义了 RYUJINX_TRACE 才会编译进去，否则宏展开为空。
+// 计数器的值只在抓取 trace 时才会求值。
+#ifdef RYUJINX_TRACE
+
+#include <android/trace.h>
+
+namespace RyujinxOboe {
+
+class AudioTraceScope {
+public:
+    explicit AudioTraceScope(const char* name) { ATrace_beginSection(name); }
+    ~AudioTraceScope() { ATrace_endSection(); }
+
+    AudioTraceScope(const AudioTraceScope&) = delete;
+    AudioTraceScope& operator=(const AudioTraceScope&) = delete;
+};
+
+} // namespace RyujinxOboe
+
+#define AUDIO_TRACE_CONCAT_INNER(a, b) a##b
+#define AUDIO_TRACE_CONCAT(a, b) AUDIO_TRACE_CONCAT_INNER(a, b)
+#define AUDIO_TRACE_SCOPE(name) ::RyujinxOboe::AudioTraceScope AUDIO_TRACE_CONCAT(audio_trace_scope_, __LINE__)(name)
+#define AUDIO_TRACE_COUNTER(name, value) \
+    do { \
+        if (ATrace_isEnabled()) ATrace_setCounter(name, static_cast<int64_t>(value)); \
+    } while (0)
+
+#else
+
+#define AUDIO_TRACE_SCOPE(name) do {} while (0)
+#define AUDIO_TRACE_COUNTER(name, value) do {} while (0)
+
+#endif
+
+#endif // RYUJINX_AUDIO_TRACE_H
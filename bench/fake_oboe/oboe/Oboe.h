@@ -0,0 +1,332 @@
+#ifndef RYUJINX_BENCH_FAKE_OBOE_H
+#define RYUJINX_BENCH_FAKE_OBOE_H
+
+// 只用于主机上的基准程序：实现 OboeAudioRenderer 用到的那部分 Oboe 接口。
+// 没有真正的设备线程，由基准程序调用 AudioStream::Pump 模拟一次数据回调，
+// 通过 FakeDevice 控制设备格式、burst 大小以及是否允许独占模式。
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace oboe {
+
+constexpr int32_t kUnspecified = 0;
+
+enum class Result : int32_t {
+    OK = 0,
+    ErrorDisconnected = -899,
+    ErrorIllegalArgument = -898,
+    ErrorInternal = -896,
+    ErrorInvalidState = -895,
+    ErrorUnimplemented = -890,
+    ErrorClosed = -869
+};
+
+enum class StreamState : int32_t {
+    Uninitialized = 0, Open = 2, Starting = 3, Started = 4, Stopping = 9, Stopped = 10,
+    Closing = 11, Closed = 12, Disconnected = 13
+};
+
+enum class AudioFormat : int32_t { Invalid = -1, Unspecified = 0, I16 = 1, Float = 2, I24 = 3, I32 = 4 };
+enum class DataCallbackResult : int32_t { Continue = 0, Stop = 1 };
+enum class PerformanceMode : int32_t { None = 10, PowerSaving = 11, LowLatency = 12 };
+enum class SharingMode : int32_t { Exclusive = 0, Shared = 1 };
+enum class AudioApi : int32_t { Unspecified = 0, OpenSLES = 1, AAudio = 2 };
+enum class Direction : int32_t { Output = 0, Input = 1 };
+enum class Usage : int32_t { Media = 1, Game = 14 };
+enum class SampleRateConversionQuality : int32_t { None, Fastest, Low, Medium, High, Best };
+enum class ChannelMask : uint32_t { Unspecified = 0, Mono = 1, Stereo = 3, CM5Point1 = 63 };
+
+template <typename T>
+class ResultWithValue {
+public:
+    ResultWithValue(T value) : m_value(value), m_error(Result::OK) {}
+    ResultWithValue(Result error) : m_value(), m_error(error) {}
+
+    T value() const { return m_value; }
+    Result error() const { return m_error; }
+    explicit operator bool() const { return m_error == Result::OK; }
+
+private:
+    T m_value;
+    Result m_error;
+};
+
+struct FrameTimestamp {
+    int64_t position;
+    int64_t timestamp;
+};
+
+class AudioStream;
+
+class AudioStreamDataCallback {
+public:
+    virtual ~AudioStreamDataCallback() = default;
+    virtual DataCallbackResult onAudioReady(AudioStream* audioStream, void* audioData, int32_t numFrames) = 0;
+};
+
+class AudioStreamErrorCallback {
+public:
+    virtual ~AudioStreamErrorCallback() = default;
+    virtual void onErrorBeforeClose(AudioStream* /*audioStream*/, Result /*error*/) {}
+    virtual void onErrorAfterClose(AudioStream* /*audioStream*/, Result /*error*/) {}
+};
+
+// 假设备的参数，在打开流之前设置
+struct FakeDeviceConfig {
+    AudioFormat native_format = AudioFormat::Float;
+    int32_t sample_rate = 48000;
+    int32_t frames_per_burst = 192;
+    int32_t capacity_bursts = 8;
+    bool exclusive_available = true;
+    // 为 false 时 AAudio 打开失败，渲染器会退到 OpenSL ES
+    bool aaudio_available = true;
+};
+
+inline int64_t FakeMonotonicNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+class AudioStream {
+public:
+    AudioStream(const FakeDeviceConfig& device, AudioApi api, SharingMode sharing_mode, AudioFormat format,
+                int32_t channel_count, int32_t frames_per_callback,
+                AudioStreamDataCallback* data_callback, AudioStreamErrorCallback* error_callback)
+        : m_api(api), m_sharing_mode(sharing_mode), m_format(format), m_channel_count(channel_count),
+          m_sample_rate(device.sample_rate), m_frames_per_burst(device.frames_per_burst),
+          m_frames_per_callback(frames_per_callback > 0 ? frames_per_callback : device.frames_per_burst),
+          m_capacity_frames(device.frames_per_burst * device.capacity_bursts),
+          m_buffer_size_frames(m_capacity_frames),
+          m_data_callback(data_callback), m_error_callback(error_callback) {
+        int32_t bytes_per_sample = format == AudioFormat::I16 ? 2 : format == AudioFormat::I24 ? 3 : 4;
+        m_buffer.resize(static_cast<size_t>(std::max(m_frames_per_callback, m_capacity_frames)) *
+                        channel_count * bytes_per_sample);
+    }
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    int32_t getChannelCount() const { return m_channel_count; }
+    int32_t getSampleRate() const { return m_sample_rate; }
+    AudioFormat getFormat() const { return m_format; }
+    AudioApi getAudioApi() const { return m_api; }
+    SharingMode getSharingMode() const { return m_sharing_mode; }
+    int32_t getFramesPerBurst() const { return m_frames_per_burst; }
+    int32_t getFramesPerDataCallback() const { return m_frames_per_callback; }
+    int32_t getBufferCapacityInFrames() const { return m_capacity_frames; }
+    int32_t getBufferSizeInFrames() const { return m_buffer_size_frames; }
+
+    StreamState getState() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_state;
+    }
+
+    ResultWithValue<int32_t> setBufferSizeInFrames(int32_t frames) {
+        m_buffer_size_frames = std::clamp(frames, m_frames_per_burst, m_capacity_frames);
+        return m_buffer_size_frames;
+    }
+
+    Result requestStart() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state != StreamState::Open && m_state != StreamState::Stopped) return Result::ErrorInvalidState;
+        m_state = StreamState::Started;
+        return Result::OK;
+    }
+
+    // 与真实设备一样，返回之后不会再有回调
+    Result stop(int64_t = 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state == StreamState::Started) m_state = StreamState::Stopped;
+        return Result::OK;
+    }
+
+    Result close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state != StreamState::Disconnected) m_state = StreamState::Closed;
+        return Result::OK;
+    }
+
+    ResultWithValue<int32_t> getXRunCount() {
+        if (m_api == AudioApi::OpenSLES) return Result::ErrorUnimplemented;
+        return m_xrun_count;
+    }
+
+    ResultWithValue<FrameTimestamp> getTimestamp(clockid_t) {
+        if (m_api == AudioApi::OpenSLES) return Result::ErrorUnimplemented;
+        // 设备缓冲区里的帧还没播放
+        int64_t position = m_frames_read - m_buffer_size_frames;
+        if (position < 0) return Result::ErrorInvalidState;
+        return FrameTimestamp{position, m_last_callback_ns};
+    }
+
+    // 以下为假设备的控制接口，只由基准程序调用
+
+    // 模拟一次数据回调。lateness_ns 为相对计划时间的延迟，超过设备缓冲区的余量时计为一次 xrun。
+    // 流没有启动时返回 false。
+    bool Pump(int64_t lateness_ns) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state != StreamState::Started || !m_data_callback) return false;
+
+        int64_t slack_frames = m_buffer_size_frames - m_frames_per_callback;
+        if (lateness_ns > 0 && lateness_ns * m_sample_rate / 1000000000LL > slack_frames) {
+            ++m_xrun_count;
+        }
+
+        m_last_callback_ns = FakeMonotonicNs();
+        auto result = m_data_callback->onAudioReady(this, m_buffer.data(), m_frames_per_callback);
+        m_frames_read += m_frames_per_callback;
+        if (result == DataCallbackResult::Stop) {
+            m_state = StreamState::Stopped;
+        }
+        return true;
+    }
+
+    // 模拟设备断开：与 Oboe 相同，先回调 onErrorBeforeClose，关闭流，再回调 onErrorAfterClose
+    void InjectDisconnect() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_state != StreamState::Started) return;
+            m_state = StreamState::Disconnected;
+        }
+        if (m_error_callback) m_error_callback->onErrorBeforeClose(this, Result::ErrorDisconnected);
+        if (m_error_callback) m_error_callback->onErrorAfterClose(this, Result::ErrorDisconnected);
+    }
+
+    const void* GetLastBuffer() const { return m_buffer.data(); }
+
+private:
+    mutable std::mutex m_mutex;
+    StreamState m_state = StreamState::Open;
+
+    AudioApi m_api;
+    SharingMode m_sharing_mode;
+    AudioFormat m_format;
+    int32_t m_channel_count;
+    int32_t m_sample_rate;
+    int32_t m_frames_per_burst;
+    int32_t m_frames_per_callback;
+    int32_t m_capacity_frames;
+    int32_t m_buffer_size_frames;
+
+    AudioStreamDataCallback* m_data_callback;
+    AudioStreamErrorCallback* m_error_callback;
+    std::vector<uint8_t> m_buffer;
+
+    int32_t m_xrun_count = 0;
+    int64_t m_frames_read = 0;
+    int64_t m_last_callback_ns = 0;
+};
+
+// 保存设备参数和最近打开的流，基准程序从这里拿到要驱动的流
+class FakeDevice {
+public:
+    static FakeDeviceConfig& Config() {
+        static FakeDeviceConfig config;
+        return config;
+    }
+
+    static std::shared_ptr<AudioStream> CurrentStream() {
+        std::lock_guard<std::mutex> lock(Mutex());
+        return Current().lock();
+    }
+
+    static int32_t OpenCount() {
+        std::lock_guard<std::mutex> lock(Mutex());
+        return Opened();
+    }
+
+    static void OnOpened(const std::shared_ptr<AudioStream>& stream) {
+        std::lock_guard<std::mutex> lock(Mutex());
+        Current() = stream;
+        ++Opened();
+    }
+
+private:
+    static std::mutex& Mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::weak_ptr<AudioStream>& Current() {
+        static std::weak_ptr<AudioStream> stream;
+        return stream;
+    }
+
+    static int32_t& Opened() {
+        static int32_t count = 0;
+        return count;
+    }
+};
+
+class AudioStreamBuilder {
+public:
+    AudioStreamBuilder* setPerformanceMode(PerformanceMode) { return this; }
+    AudioStreamBuilder* setAudioApi(AudioApi api) { m_api = api; return this; }
+    AudioStreamBuilder* setSharingMode(SharingMode mode) { m_sharing_mode = mode; return this; }
+    AudioStreamBuilder* setDirection(Direction) { return this; }
+    AudioStreamBuilder* setSampleRate(int32_t) { return this; }
+    AudioStreamBuilder* setSampleRateConversionQuality(SampleRateConversionQuality) { return this; }
+    AudioStreamBuilder* setFormat(AudioFormat format) { m_format = format; return this; }
+    AudioStreamBuilder* setFormatConversionAllowed(bool) { return this; }
+    AudioStreamBuilder* setChannelConversionAllowed(bool) { return this; }
+    AudioStreamBuilder* setUsage(Usage) { return this; }
+    AudioStreamBuilder* setFramesPerCallback(int32_t frames) { m_frames_per_callback = frames; return this; }
+    AudioStreamBuilder* setFramesPerDataCallback(int32_t frames) { m_frames_per_callback = frames; return this; }
+    AudioStreamBuilder* setChannelCount(int32_t channels) { m_channel_count = channels; return this; }
+    AudioStreamBuilder* setChannelMask(ChannelMask) { return this; }
+    AudioStreamBuilder* setDataCallback(AudioStreamDataCallback* callback) { m_data_callback = callback; return this; }
+    AudioStreamBuilder* setErrorCallback(AudioStreamErrorCallback* callback) { m_error_callback = callback; return this; }
+
+    Result openStream(std::shared_ptr<AudioStream>& stream) {
+        const FakeDeviceConfig& device = FakeDevice::Config();
+        if (m_api == AudioApi::AAudio && !device.aaudio_available) {
+            return Result::ErrorInternal;
+        }
+
+        // 与 AAudio 一样，独占模式不可用时静默降级为共享模式
+        SharingMode sharing_mode = m_sharing_mode;
+        if (m_api != AudioApi::AAudio || !device.exclusive_available) {
+            sharing_mode = SharingMode::Shared;
+        }
+
+        AudioFormat format = m_format == AudioFormat::Unspecified ? device.native_format : m_format;
+        int32_t channels = m_channel_count > 0 ? m_channel_count : 2;
+
+        stream = std::make_shared<AudioStream>(device, m_api, sharing_mode, format, channels,
+                                               m_frames_per_callback, m_data_callback, m_error_callback);
+        FakeDevice::OnOpened(stream);
+        return Result::OK;
+    }
+
+private:
+    AudioApi m_api = AudioApi::Unspecified;
+    SharingMode m_sharing_mode = SharingMode::Shared;
+    AudioFormat m_format = AudioFormat::Unspecified;
+    int32_t m_channel_count = kUnspecified;
+    int32_t m_frames_per_callback = kUnspecified;
+    AudioStreamDataCallback* m_data_callback = nullptr;
+    AudioStreamErrorCallback* m_error_callback = nullptr;
+};
+
+class AAudioExtensions {
+public:
+    static AAudioExtensions& getInstance() {
+        static AAudioExtensions instance;
+        return instance;
+    }
+
+    // 假设备上独占流一律视为走 MMAP
+    bool isMMapUsed(AudioStream* stream) {
+        return stream && stream->getAudioApi() == AudioApi::AAudio && stream->getSharingMode() == SharingMode::Exclusive;
+    }
+};
+
+} // namespace oboe
+
+#endif // RYUJINX_BENCH_FAKE_OBOE_H
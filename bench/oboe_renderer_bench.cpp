@@ -0,0 +1,573 @@
+// OboeAudioRenderer 的主机基准/压力测试程序。
+// 用 fake_oboe 里的假 AudioStream 代替设备，按设定的 burst 大小驱动数据回调，
+// 同时由生产者线程调用 WriteAudioRaw（或 BeginWrite/CommitWrite），可以加入抖动、时钟偏差、
+// 额外的混音输入、音量渐变和设备断开。
+//
+// 两种模式：
+//   offline   单线程交替写入和回调，不等待，用来比较回调本身的吞吐
+//   realtime  按真实时间（可用 --speed 加速）运行生产者和回调，用来观察欠载、xrun 和延迟控制
+//
+// 回调线程上发生内存分配时以非零状态退出，便于在回归脚本里使用。
+
+#include "oboe_audio_renderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using RyujinxOboe::OboeAudioRenderer;
+
+namespace {
+
+// 统计 operator new 的调用次数，按线程分别计数
+std::atomic<int64_t> g_allocations{0};
+thread_local int64_t t_allocations = 0;
+
+void* CountedAlloc(size_t size, size_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    ++t_allocations;
+    if (size == 0) size = 1;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    void* p = CountedAlloc(size, 0);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) {
+    void* p = CountedAlloc(size, 0);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* p = CountedAlloc(size, static_cast<size_t>(alignment));
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* p = CountedAlloc(size, static_cast<size_t>(alignment));
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size, 0); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+    bool realtime = true;
+    int32_t buffer_mode = RyujinxOboe::BUFFER_MODE_RING;
+    int32_t sample_format = RyujinxOboe::PCM_INT16;
+    int32_t channels = 2;
+    int32_t sample_rate = 48000;
+    int32_t frames_per_callback = 0;
+    int32_t write_frames = 240;
+    double duration_s = 10.0;
+    double speed = 1.0;
+    int32_t jitter_us = 0;
+    double drift_ppm = 0.0;
+    bool drift_compensation = true;
+    int32_t inputs = 0;
+    int32_t volume_every_ms = 0;
+    int32_t restart_every_ms = 0;
+    bool zero_copy = false;
+    uint32_t seed = 1;
+};
+
+// 预先分配好空间，记录时不在被测区域内分配
+class Samples {
+public:
+    explicit Samples(size_t reserve) { m_values.reserve(reserve); }
+
+    void Add(int64_t value) {
+        if (m_values.size() < m_values.capacity()) m_values.push_back(value);
+    }
+
+    size_t Count() const { return m_values.size(); }
+
+    void Print(const char* name) {
+        if (m_values.empty()) {
+            std::printf("%-18s (none)\n", name);
+            return;
+        }
+        std::sort(m_values.begin(), m_values.end());
+        auto at = [this](double q) {
+            size_t index = std::min(m_values.size() - 1, static_cast<size_t>(q * static_cast<double>(m_values.size())));
+            return static_cast<double>(m_values[index]) / 1000.0;
+        };
+        std::printf("%-18s p50 %8.2f  p90 %8.2f  p99 %8.2f  p99.9 %8.2f  max %8.2f us\n",
+                    name, at(0.50), at(0.90), at(0.99), at(0.999),
+                    static_cast<double>(m_values.back()) / 1000.0);
+    }
+
+private:
+    std::vector<int64_t> m_values;
+};
+
+int32_t ParseFormat(const std::string& value) {
+    if (value == "i16") return RyujinxOboe::PCM_INT16;
+    if (value == "i24") return RyujinxOboe::PCM_INT24;
+    if (value == "i32") return RyujinxOboe::PCM_INT32;
+    if (value == "float") return RyujinxOboe::PCM_FLOAT;
+    return 0;
+}
+
+oboe::AudioFormat ParseOboeFormat(const std::string& value) {
+    if (value == "i16") return oboe::AudioFormat::I16;
+    if (value == "i24") return oboe::AudioFormat::I24;
+    if (value == "i32") return oboe::AudioFormat::I32;
+    if (value == "float") return oboe::AudioFormat::Float;
+    return oboe::AudioFormat::Invalid;
+}
+
+bool ParseSwitch(const std::string& value) {
+    return value == "on" || value == "1" || value == "true";
+}
+
+void PrintUsage(const char* program) {
+    std::printf(
+        "usage: %s [options]\n"
+        "  --mode offline|realtime      drive callbacks back to back, or paced in real time (realtime)\n"
+        "  --buffer ring|block          renderer buffer mode (ring)\n"
+        "  --format i16|i24|i32|float   producer sample format (i16)\n"
+        "  --channels N                 producer channel count (2)\n"
+        "  --device-format FMT          native format of the fake device (float)\n"
+        "  --rate HZ                    sample rate (48000)\n"
+        "  --burst N                    device frames per burst (192)\n"
+        "  --capacity-bursts N          device buffer capacity in bursts (8)\n"
+        "  --frames-per-callback N      fixed callback size, 0 for one burst (0)\n"
+        "  --write-frames N             frames per producer write (240)\n"
+        "  --duration S                 audio seconds to render (10)\n"
+        "  --speed X                    realtime clock multiplier (1)\n"
+        "  --jitter-us N                max random producer lateness per write (0)\n"
+        "  --drift-ppm N                producer clock offset against the device (0)\n"
+        "  --drift-compensation on|off  resampler drift compensation in ring mode (on)\n"
+        "  --inputs N                   extra mixer inputs fed alongside the main one (0)\n"
+        "  --volume-every-ms N          toggle the volume to exercise the gain ramp (0 = off)\n"
+        "  --restart-every-ms N         inject a device disconnect (0 = off, realtime only)\n"
+        "  --exclusive on|off           whether the fake device grants exclusive mode (on)\n"
+        "  --aaudio on|off              whether AAudio opens, off falls back to OpenSL ES (on)\n"
+        "  --api raw|zerocopy           WriteAudioRaw or BeginWrite/CommitWrite (raw)\n"
+        "  --seed N                     jitter random seed (1)\n",
+        program);
+}
+
+bool ParseArgs(int argc, char** argv, BenchConfig& config) {
+    oboe::FakeDeviceConfig& device = oboe::FakeDevice::Config();
+
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "--help" || key == "-h") return false;
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", key.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (key == "--mode") {
+            if (value != "offline" && value != "realtime") return false;
+            config.realtime = value == "realtime";
+        } else if (key == "--buffer") {
+            if (value != "ring" && value != "block") return false;
+            config.buffer_mode = value == "ring" ? RyujinxOboe::BUFFER_MODE_RING : RyujinxOboe::BUFFER_MODE_BLOCK_QUEUE;
+        } else if (key == "--format") {
+            config.sample_format = ParseFormat(value);
+            if (config.sample_format == 0) return false;
+        } else if (key == "--channels") {
+            config.channels = std::atoi(value.c_str());
+        } else if (key == "--device-format") {
+            device.native_format = ParseOboeFormat(value);
+            if (device.native_format == oboe::AudioFormat::Invalid) return false;
+        } else if (key == "--rate") {
+            config.sample_rate = std::atoi(value.c_str());
+        } else if (key == "--burst") {
+            device.frames_per_burst = std::atoi(value.c_str());
+        } else if (key == "--capacity-bursts") {
+            device.capacity_bursts = std::atoi(value.c_str());
+        } else if (key == "--frames-per-callback") {
+            config.frames_per_callback = std::atoi(value.c_str());
+        } else if (key == "--write-frames") {
+            config.write_frames = std::atoi(value.c_str());
+        } else if (key == "--duration") {
+            config.duration_s = std::atof(value.c_str());
+        } else if (key == "--speed") {
+            config.speed = std::atof(value.c_str());
+        } else if (key == "--jitter-us") {
+            config.jitter_us = std::atoi(value.c_str());
+        } else if (key == "--drift-ppm") {
+            config.drift_ppm = std::atof(value.c_str());
+        } else if (key == "--drift-compensation") {
+            config.drift_compensation = ParseSwitch(value);
+        } else if (key == "--inputs") {
+            config.inputs = std::atoi(value.c_str());
+        } else if (key == "--volume-every-ms") {
+            config.volume_every_ms = std::atoi(value.c_str());
+        } else if (key == "--restart-every-ms") {
+            config.restart_every_ms = std::atoi(value.c_str());
+        } else if (key == "--exclusive") {
+            device.exclusive_available = ParseSwitch(value);
+        } else if (key == "--aaudio") {
+            device.aaudio_available = ParseSwitch(value);
+        } else if (key == "--api") {
+            if (value != "raw" && value != "zerocopy") return false;
+            config.zero_copy = value == "zerocopy";
+        } else if (key == "--seed") {
+            config.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", key.c_str());
+            return false;
+        }
+    }
+
+    device.sample_rate = config.sample_rate;
+    if (config.channels < 1 || config.channels > RyujinxOboe::AudioFormatConverter::MAX_CHANNELS ||
+        config.sample_rate <= 0 || device.frames_per_burst <= 0 || device.capacity_bursts <= 0 ||
+        config.write_frames <= 0 || config.duration_s <= 0.0 || config.speed <= 0.0) {
+        std::fprintf(stderr, "invalid option value\n");
+        return false;
+    }
+    if (config.zero_copy && config.buffer_mode != RyujinxOboe::BUFFER_MODE_RING) {
+        std::fprintf(stderr, "--api zerocopy requires --buffer ring\n");
+        return false;
+    }
+    return true;
+}
+
+// 生成一段正弦波，格式为 sample_format，生产者循环使用
+std::vector<uint8_t> MakeSignal(int32_t sample_format, int32_t channels, int32_t frames, int32_t sample_rate) {
+    RyujinxOboe::AudioFormatConverter converter;
+    converter.Configure(RyujinxOboe::PCM_FLOAT, channels, sample_format, channels);
+
+    std::vector<float> source(static_cast<size_t>(frames) * channels);
+    for (int32_t i = 0; i < frames; ++i) {
+        float value = 0.5f * std::sin(2.0f * 3.14159265f * 440.0f * static_cast<float>(i) / static_cast<float>(sample_rate));
+        for (int32_t c = 0; c < channels; ++c) {
+            source[static_cast<size_t>(i) * channels + c] = value;
+        }
+    }
+
+    std::vector<uint8_t> signal(static_cast<size_t>(frames) * converter.GetDestinationFrameBytes());
+    converter.Convert(source.data(), signal.data(), frames);
+    return signal;
+}
+
+struct ProducerStats {
+    Samples write_ns;
+    int64_t allocations = 0;
+    int64_t writes = 0;
+    int64_t failed_writes = 0;
+
+    explicit ProducerStats(size_t reserve) : write_ns(reserve) {}
+};
+
+class Producer {
+public:
+    Producer(OboeAudioRenderer& renderer, const BenchConfig& config, const std::vector<int32_t>& inputs)
+        : m_renderer(renderer), m_config(config), m_inputs(inputs),
+          m_signal(MakeSignal(config.sample_format, config.channels, config.write_frames, config.sample_rate)),
+          m_input_signal(MakeSignal(RyujinxOboe::PCM_INT16, 2, config.write_frames, config.sample_rate)) {}
+
+    // 写入一次 write_frames，返回是否全部写入
+    bool WriteOnce(ProducerStats& stats) {
+        int64_t allocations = t_allocations;
+        auto start = Clock::now();
+
+        bool written = m_config.zero_copy ? WriteZeroCopy() : m_renderer.WriteAudioRaw(m_signal.data(), m_config.write_frames, m_config.sample_format);
+        for (int32_t id : m_inputs) {
+            m_renderer.WriteInput(id, m_input_signal.data(), m_config.write_frames);
+        }
+
+        stats.write_ns.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        stats.allocations += t_allocations - allocations;
+        ++stats.writes;
+        if (!written) ++stats.failed_writes;
+
+        if (m_config.volume_every_ms > 0) {
+            m_frames_since_volume += m_config.write_frames;
+            if (m_frames_since_volume >= m_config.sample_rate / 1000 * m_config.volume_every_ms) {
+                m_frames_since_volume = 0;
+                m_low_volume = !m_low_volume;
+                m_renderer.SetVolume(m_low_volume ? 0.25f : 1.0f);
+            }
+        }
+        return written;
+    }
+
+private:
+    bool WriteZeroCopy() {
+        size_t frame_bytes = m_signal.size() / static_cast<size_t>(m_config.write_frames);
+        int32_t done = 0;
+        while (done < m_config.write_frames) {
+            RyujinxOboe::WriteRegion region = m_renderer.BeginWrite(m_config.write_frames - done);
+            if (region.frames == 0) return false;
+            std::memcpy(region.data, m_signal.data() + static_cast<size_t>(done) * frame_bytes,
+                        static_cast<size_t>(region.frames) * frame_bytes);
+            m_renderer.CommitWrite(region.frames);
+            done += region.frames;
+        }
+        return true;
+    }
+
+    OboeAudioRenderer& m_renderer;
+    const BenchConfig& m_config;
+    const std::vector<int32_t>& m_inputs;
+    std::vector<uint8_t> m_signal;
+    std::vector<uint8_t> m_input_signal;
+    int32_t m_frames_since_volume = 0;
+    bool m_low_volume = false;
+};
+
+struct CallbackStats {
+    Samples callback_ns;
+    Samples lateness_ns;
+    int64_t allocations = 0;
+    int64_t callbacks = 0;
+    int64_t skipped = 0;
+    int64_t busy_ns = 0;
+
+    explicit CallbackStats(size_t reserve) : callback_ns(reserve), lateness_ns(reserve) {}
+};
+
+// 驱动当前流的一次回调，流正在重建时返回 false
+bool RunCallback(CallbackStats& stats, int64_t lateness_ns) {
+    auto stream = oboe::FakeDevice::CurrentStream();
+    if (!stream) {
+        ++stats.skipped;
+        return false;
+    }
+
+    int64_t allocations = t_allocations;
+    auto start = Clock::now();
+    bool ran = stream->Pump(lateness_ns);
+    int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    if (!ran) {
+        ++stats.skipped;
+        return false;
+    }
+
+    stats.allocations += t_allocations - allocations;
+    stats.callback_ns.Add(duration);
+    stats.busy_ns += duration;
+    ++stats.callbacks;
+    return true;
+}
+
+void RunOffline(OboeAudioRenderer& renderer, const BenchConfig& config, Producer& producer,
+                ProducerStats& producer_stats, CallbackStats& callback_stats, int64_t total_frames) {
+    const oboe::FakeDeviceConfig& device = oboe::FakeDevice::Config();
+    int32_t callback_frames = config.frames_per_callback > 0 ? config.frames_per_callback : device.frames_per_burst;
+    // 保持两个回调的余量，避免人为欠载
+    int32_t target_fill = callback_frames * 2 + config.write_frames;
+    int64_t rendered = 0;
+    int32_t failed_in_row = 0;
+
+    while (rendered < total_frames) {
+        while (renderer.GetBufferedFrames() < target_fill) {
+            if (producer.WriteOnce(producer_stats)) {
+                failed_in_row = 0;
+            } else if (++failed_in_row > 4) {
+                break;
+            }
+        }
+
+        if (!RunCallback(callback_stats, 0)) {
+            break;
+        }
+        rendered += callback_frames;
+    }
+}
+
+void RunRealtime(const BenchConfig& config, Producer& producer, ProducerStats& producer_stats,
+                  CallbackStats& callback_stats, int64_t total_frames) {
+    const oboe::FakeDeviceConfig& device = oboe::FakeDevice::Config();
+    int32_t callback_frames = config.frames_per_callback > 0 ? config.frames_per_callback : device.frames_per_burst;
+    std::atomic<bool> running{true};
+    auto start = Clock::now();
+
+    // 生产者的时钟按 drift_ppm 偏离设备时钟，每次写入再随机推迟 0~jitter_us
+    std::thread producer_thread([&] {
+        std::mt19937 random(config.seed);
+        std::uniform_int_distribution<int32_t> jitter(0, std::max(0, config.jitter_us));
+        double period_ns = config.write_frames * 1e9 / (config.sample_rate * (1.0 + config.drift_ppm * 1e-6)) / config.speed;
+        for (int64_t k = 0; running.load(std::memory_order_relaxed); ++k) {
+            auto due = start + std::chrono::nanoseconds(static_cast<int64_t>(period_ns * static_cast<double>(k)));
+            int32_t late_us = config.jitter_us > 0 ? jitter(random) : 0;
+            std::this_thread::sleep_until(due + std::chrono::microseconds(static_cast<int64_t>(late_us / config.speed)));
+            producer.WriteOnce(producer_stats);
+        }
+    });
+
+    double period_ns = callback_frames * 1e9 / config.sample_rate / config.speed;
+    int64_t restart_every = config.restart_every_ms > 0
+                            ? static_cast<int64_t>(config.sample_rate) * config.restart_every_ms / 1000 / callback_frames
+                            : 0;
+    int64_t callbacks_total = total_frames / callback_frames;
+
+    // 让生产者先写入一点数据
+    auto first = start + std::chrono::nanoseconds(static_cast<int64_t>(period_ns));
+    for (int64_t n = 0; n < callbacks_total; ++n) {
+        auto due = first + std::chrono::nanoseconds(static_cast<int64_t>(period_ns * static_cast<double>(n)));
+        std::this_thread::sleep_until(due);
+        int64_t lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - due).count();
+        // 设备延迟按设备时间计算
+        int64_t device_lateness = static_cast<int64_t>(static_cast<double>(lateness) * config.speed);
+        callback_stats.lateness_ns.Add(device_lateness);
+
+        RunCallback(callback_stats, device_lateness);
+
+        if (restart_every > 0 && n > 0 && n % restart_every == 0) {
+            if (auto stream = oboe::FakeDevice::CurrentStream()) {
+                stream->InjectDisconnect();
+            }
+        }
+    }
+
+    running.store(false);
+    producer_thread.join();
+}
+
+const char* FormatName(int32_t format) {
+    switch (format) {
+        case RyujinxOboe::PCM_INT16: return "i16";
+        case RyujinxOboe::PCM_INT24: return "i24";
+        case RyujinxOboe::PCM_INT32: return "i32";
+        case RyujinxOboe::PCM_FLOAT: return "float";
+        default:                     return "?";
+    }
+}
+
+const char* OboeFormatName(oboe::AudioFormat format) {
+    switch (format) {
+        case oboe::AudioFormat::I16:   return "i16";
+        case oboe::AudioFormat::I24:   return "i24";
+        case oboe::AudioFormat::I32:   return "i32";
+        case oboe::AudioFormat::Float: return "float";
+        default:                       return "?";
+    }
+}
+
+const char* TierName(int32_t tier) {
+    switch (tier) {
+        case RyujinxOboe::STREAM_TIER_AAUDIO_EXCLUSIVE: return "aaudio-exclusive";
+        case RyujinxOboe::STREAM_TIER_AAUDIO_SHARED:    return "aaudio-shared";
+        case RyujinxOboe::STREAM_TIER_OPENSL_ES:        return "opensl-es";
+        default:                                        return "none";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!ParseArgs(argc, argv, config)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    const oboe::FakeDeviceConfig& device = oboe::FakeDevice::Config();
+    int64_t total_frames = static_cast<int64_t>(config.duration_s * config.sample_rate);
+    int32_t callback_frames = config.frames_per_callback > 0 ? config.frames_per_callback : device.frames_per_burst;
+    size_t reserve = static_cast<size_t>(total_frames / std::min(callback_frames, config.write_frames)) * 2 + 1024;
+
+    auto renderer = std::make_unique<OboeAudioRenderer>();
+    renderer->SetBufferMode(config.buffer_mode);
+    renderer->SetDriftCompensation(config.drift_compensation);
+    renderer->SetFramesPerCallback(config.frames_per_callback);
+    renderer->SetBackpressurePolicy(RyujinxOboe::BACKPRESSURE_DROP, 0);
+
+    if (!renderer->InitializeWithFormat(config.sample_rate, config.channels, config.sample_format)) {
+        std::fprintf(stderr, "failed to initialize the renderer\n");
+        return 1;
+    }
+
+    std::vector<int32_t> inputs;
+    for (int32_t i = 0; i < config.inputs; ++i) {
+        int32_t id = renderer->OpenInput(2, RyujinxOboe::PCM_INT16);
+        if (id < 0) {
+            std::fprintf(stderr, "failed to open mixer input %d\n", i);
+            return 1;
+        }
+        inputs.push_back(id);
+    }
+
+    Producer producer(*renderer, config, inputs);
+    ProducerStats producer_stats(reserve);
+    CallbackStats callback_stats(reserve);
+
+    auto wall_start = Clock::now();
+    if (config.realtime) {
+        RunRealtime(config, producer, producer_stats, callback_stats, total_frames);
+    } else {
+        RunOffline(*renderer, config, producer, producer_stats, callback_stats, total_frames);
+    }
+    double wall_s = std::chrono::duration<double>(Clock::now() - wall_start).count();
+
+    RyujinxOboe::AudioStats stats;
+    renderer->GetStats(stats);
+    auto stream = oboe::FakeDevice::CurrentStream();
+
+    double rendered_s = static_cast<double>(callback_stats.callbacks) * callback_frames / config.sample_rate;
+    double busy_s = static_cast<double>(callback_stats.busy_ns) * 1e-9;
+
+    std::printf("config             mode=%s buffer=%s format=%s channels=%d device=%s/%dch burst=%d callback=%d\n",
+                config.realtime ? "realtime" : "offline",
+                config.buffer_mode == RyujinxOboe::BUFFER_MODE_RING ? "ring" : "block",
+                FormatName(config.sample_format), config.channels,
+                stream ? OboeFormatName(stream->getFormat()) : "?",
+                stream ? stream->getChannelCount() : 0, device.frames_per_burst, callback_frames);
+    std::printf("                   write=%d jitter=%dus drift=%.0fppm compensation=%s inputs=%d api=%s tier=%s\n",
+                config.write_frames, config.jitter_us, config.drift_ppm, config.drift_compensation ? "on" : "off",
+                config.inputs, config.zero_copy ? "zerocopy" : "raw", TierName(renderer->GetStreamTier()));
+    std::printf("callbacks          %lld (skipped %lld) in %.2f s wall\n",
+                static_cast<long long>(callback_stats.callbacks), static_cast<long long>(callback_stats.skipped), wall_s);
+    std::printf("throughput         %.1f x realtime (%.1f Mframes/s of callback time)\n",
+                busy_s > 0.0 ? rendered_s / busy_s : 0.0,
+                busy_s > 0.0 ? static_cast<double>(callback_stats.callbacks) * callback_frames / busy_s * 1e-6 : 0.0);
+    callback_stats.callback_ns.Print("callback");
+    if (config.realtime) {
+        callback_stats.lateness_ns.Print("callback lateness");
+    }
+    producer_stats.write_ns.Print("write");
+    std::printf("writes             %lld (failed %lld)\n",
+                static_cast<long long>(producer_stats.writes), static_cast<long long>(producer_stats.failed_writes));
+    std::printf("underruns          %d\n", stats.underrun_count);
+    std::printf("overruns           %d\n", stats.overrun_count);
+    std::printf("xruns              %d (buffer target %d frames)\n", stats.xrun_count, renderer->GetLatencyTargetFrames());
+    std::printf("restarts           %d (streams opened %d)\n", renderer->GetRestartCount(), oboe::FakeDevice::OpenCount());
+    std::printf("drift correction   %.1f ppm\n", stats.drift_correction_ppm);
+    std::printf("frames             written %lld played %lld buffered %d\n",
+                static_cast<long long>(stats.frames_written), static_cast<long long>(stats.frames_played),
+                stats.buffered_frames);
+    std::printf("allocations        callback %lld, producer %lld, total %lld\n",
+                static_cast<long long>(callback_stats.allocations), static_cast<long long>(producer_stats.allocations),
+                static_cast<long long>(g_allocations.load()));
+
+    renderer->Shutdown();
+    return callback_stats.allocations > 0 ? 1 : 0;
+}
@@ -1,54 +1,115 @@
 #include "oboe_audio_renderer.h"
+#include "audio_trace.h"
+#include "audio_host_hooks.h"
 #include <cstring>
+#include <cmath>
 #include <algorithm>
 #include <thread>
 #include <chrono>
+#include <type_traits>
+#include <unistd.h>
 
 namespace RyujinxOboe {
 
+namespace {
+
+// 与 AudioFormatConverter 的编解码保持一致
+constexpr float INT16_SCALE = 32768.0f;
+
+template <typename T>
+inline float DecodeSample(T sample) {
+    if constexpr (std::is_same_v<T, int16_t>) {
+        return static_cast<float>(sample) * (1.0f / INT16_SCALE);
+    } else {
+        return sample;
+    }
+}
+
+template <typename T>
+inline T EncodeSample(float value) {
+    if constexpr (std::is_same_v<T, int16_t>) {
+        return static_cast<int16_t>(std::clamp(std::nearbyint(value * INT16_SCALE), -32768.0f, 32767.0f));
+    } else {
+        return value;
+    }
+}
+
+// 立体声解码、增益、编码合并为一次遍历，类型和步长都是编译期常量，编译器可以直接向量化
+template <typename SrcT, typename DstT>
+void ConvertStereo(const SrcT* src, DstT* dst, int32_t frames, float gain, float gain_step) {
+    for (int32_t i = 0; i < frames; ++i) {
+        float g = gain + gain_step * static_cast<float>(i);
+        dst[i * 2] = EncodeSample<DstT>(DecodeSample(src[i * 2]) * g);
+        dst[i * 2 + 1] = EncodeSample<DstT>(DecodeSample(src[i * 2 + 1]) * g);
+    }
+}
+
+template <typename T>
+constexpr int32_t SampleFormatOf() {
+    return std::is_same_v<T, int16_t> ? PCM_INT16 : PCM_FLOAT;
+}
+
+long PresentationTimeProvider(void* context) {
+    return static_cast<long>(static_cast<const OboeAudioRenderer*>(context)->GetNextWritePresentationTimeNs());
+}
+
+} // namespace
+
 OboeAudioRenderer::OboeAudioRenderer() {
     m_audio_callback = std::make_unique<SimpleAudioCallback>(this);
     m_error_callback = std::make_unique<SimpleErrorCallback>(this);
-    InitializePool();
+    m_recovery_thread = std::thread(&OboeAudioRenderer::RecoveryThreadMain, this);
 }
 
 OboeAudioRenderer::~OboeAudioRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(m_recovery_mutex);
+        m_recovery_exit = true;
+    }
+    m_recovery_cv.notify_one();
+    if (m_recovery_thread.joinable()) {
+        m_recovery_thread.join();
+    }
+    
     Shutdown();
 }
 
 void OboeAudioRenderer::InitializePool() {
-    std::lock_guard<std::mutex> lock(m_pool_mutex);
-    const size_t POOL_SIZE = 64;
-    m_block_pool.reserve(POOL_SIZE);
+    if (m_pool_initialized) return;
     
-    for (size_t i = 0; i < POOL_SIZE; ++i) {
+    // 一次性分配所有块，之后不再分配，回调线程归还时也不会释放内存
+    for (uint32_t i = 0; i < BLOCK_POOL_SIZE; ++i) {
         auto block = std::make_unique<AudioBlock>();
         block->clear();
-        m_block_pool.push_back(std::move(block));
+        m_free_blocks.push(std::move(block));
     }
+    
+    m_pool_initialized = true;
 }
 
 std::unique_ptr<AudioBlock> OboeAudioRenderer::AcquireBlock() {
-    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    // 上一次没能入队的块留在生产者手里，优先复用
+    if (m_spare_block) {
+        return std::move(m_spare_block);
+    }
     
-    if (!m_block_pool.empty()) {
-        auto block = std::move(m_block_pool.back());
-        m_block_pool.pop_back();
-        return block;
+    std::unique_ptr<AudioBlock> block;
+    
+    // 池空了说明队列已满，由调用方按背压处理
+    if (!m_free_blocks.pop(block)) {
+        return nullptr;
     }
     
-    // 池空了，创建新块
-    auto block = std::make_unique<AudioBlock>();
-    block->clear();
     return block;
 }
 
 void OboeAudioRenderer::ReleaseBlock(std::unique_ptr<AudioBlock> block) {
     if (!block) return;
     
-    std::lock_guard<std::mutex> lock(m_pool_mutex);
     block->clear();
-    m_block_pool.push_back(std::move(block));
+    // 空闲队列是单生产者的：只有回调线程，或者回调停止后的控制线程可以归还。
+    // FREE_QUEUE_SIZE >= BLOCK_POOL_SIZE，归还不会失败
+    m_free_blocks.push(std::move(block));
 }
 
 bool OboeAudioRenderer::Initialize(int32_t sampleRate, int32_t channelCount) {
@@ -72,34 +133,66 @@ bool OboeAudioRenderer::InitializeWithFormat(int32_t sampleRate, int32_t channel
     m_channel_count.store(channelCount);
     m_sample_format.store(sampleFormat);
     m_oboe_format = MapSampleFormat(sampleFormat);
+    m_active_buffer_mode = m_buffer_mode.load();
+    ResetStats();
+    
+    if (!ConfigureBuffers()) {
+        return false;
+    }
     
     if (!ConfigureAndOpenStream()) {
         return false;
     }
     
     m_initialized.store(true);
+    
+    // 让呈现端和音频使用同一个时钟
+    if (setAudioPresentationTimeProvider) {
+        setAudioPresentationTimeProvider(PresentationTimeProvider, this);
+    }
     return true;
 }
 
 void OboeAudioRenderer::Shutdown() {
+    if (clearAudioPresentationTimeProvider) {
+        clearAudioPresentationTimeProvider(this);
+    }
+    
     std::lock_guard<std::mutex> lock(m_stream_mutex);
     
-    CloseStream();
     ClearAllBuffers();
+    m_mixer.CloseAllInputs();
     
     m_initialized.store(false);
     m_stream_started.store(false);
     m_needs_restart.store(false);
 }
 
+bool OboeAudioRenderer::ConfigureBuffers() {
+    if (m_active_buffer_mode != BUFFER_MODE_RING) {
+        m_ring_buffer.Release();
+        InitializePool();
+        return true;
+    }
+    
+    uint32_t bytes_per_frame = static_cast<uint32_t>(m_channel_count.load() * GetBytesPerSample(m_sample_format.load()));
+    uint32_t min_frames = static_cast<uint32_t>(m_sample_rate.load() * RING_BUFFER_MS / 1000);
+    return m_ring_buffer.Allocate(min_frames, bytes_per_frame);
+}
+
 void OboeAudioRenderer::ClearAllBuffers() {
-    m_audio_queue.clear();
+    // 先关闭流，回调停止后这里才是队列唯一的消费者和空闲队列唯一的归还者
+    CloseStream();
+    
+    m_ring_buffer.Clear();
+    // 被清掉的数据不算播放，只是让缓冲帧数归零
+    m_frames_discarded.store(m_frames_written.load() - m_frames_played.load());
     
     if (m_current_block) {
         ReleaseBlock(std::move(m_current_block));
     }
     
-    // 清理队列中的所有块
+    // 清理队列中的所有块，必须逐个归还到池中而不是直接清空队列
     std::unique_ptr<AudioBlock> block;
     while (m_audio_queue.pop(block)) {
         ReleaseBlock(std::move(block));
@@ -109,28 +202,23 @@ void OboeAudioRenderer::ClearAllBuffers() {
 void OboeAudioRenderer::ConfigureForAAudio(oboe::AudioStreamBuilder& builder) {
     builder.setPerformanceMode(oboe::PerformanceMode::LowLatency)
            ->setAudioApi(oboe::AudioApi::AAudio)
-           ->setSharingMode(oboe::SharingMode::Shared)
+           ->setSharingMode(oboe::SharingMode::Exclusive)
            ->setDirection(oboe::Direction::Output)
            ->setSampleRate(m_sample_rate.load())
            ->setSampleRateConversionQuality(oboe::SampleRateConversionQuality::High)
-           ->setFormat(m_oboe_format)
-           ->setFormatConversionAllowed(true)
+           ->setFormat(oboe::AudioFormat::Unspecified)
+           ->setFormatConversionAllowed(false)
            ->setUsage(oboe::Usage::Game)
-           ->setFramesPerCallback(240);
+           ->setFramesPerCallback(m_frames_per_callback.load());
     
-    auto channel_count = m_channel_count.load();
-    auto channel_mask = [&]() {
-        switch (channel_count) {
-        case 1: return oboe::ChannelMask::Mono;
-        case 2: return oboe::ChannelMask::Stereo;
-        case 6: return oboe::ChannelMask::CM5Point1;
-        default: return oboe::ChannelMask::Unspecified;
-        }
-    }();
+    // 使用设备原生格式，格式和声道转换由 m_output_converter 完成，
+    // 避免 Oboe 内部的转换缓冲区，也让流可以走独占/MMAP 路径
+    auto channel_count = std::min(m_channel_count.load(), 2);
+    auto channel_mask = channel_count == 1 ? oboe::ChannelMask::Mono : oboe::ChannelMask::Stereo;
     
     builder.setChannelCount(channel_count)
            ->setChannelMask(channel_mask)
-           ->setChannelConversionAllowed(true);
+           ->setChannelConversionAllowed(false);
 }
 
 bool OboeAudioRenderer::ConfigureAndOpenStream() {
@@ -140,29 +228,74 @@ bool OboeAudioRenderer::ConfigureAndOpenStream() {
     builder.setDataCallback(m_audio_callback.get())
            ->setErrorCallback(m_error_callback.get());
     
-    auto result = builder.openStream(m_stream);
+    // 依次尝试：AAudio 独占（可走 MMAP，延迟最低）-> AAudio 共享 -> OpenSL ES
+    static constexpr struct {
+        oboe::AudioApi api;
+        oboe::SharingMode sharing_mode;
+    } tiers[] = {
+        {oboe::AudioApi::AAudio,   oboe::SharingMode::Exclusive},
+        {oboe::AudioApi::AAudio,   oboe::SharingMode::Shared},
+        {oboe::AudioApi::OpenSLES, oboe::SharingMode::Shared},
+    };
     
-    if (result != oboe::Result::OK) {
-        builder.setSharingMode(oboe::SharingMode::Shared);
+    auto result = oboe::Result::ErrorInternal;
+    
+    for (const auto& tier : tiers) {
+        builder.setAudioApi(tier.api)
+               ->setSharingMode(tier.sharing_mode);
         result = builder.openStream(m_stream);
         
-        if (result != oboe::Result::OK) {
-            builder.setAudioApi(oboe::AudioApi::OpenSLES)
-                   ->setSharingMode(oboe::SharingMode::Shared);
-            result = builder.openStream(m_stream);
-            
-            if (result != oboe::Result::OK) {
-                return false;
-            }
+        if (result == oboe::Result::OK) {
+            break;
         }
     }
     
+    if (result != oboe::Result::OK) {
+        m_stream_tier.store(STREAM_TIER_NONE);
+        return false;
+    }
+    
+    // 按流实际使用的 API 和共享模式记录：Oboe 可能悄悄退到 OpenSL ES，
+    // 独占模式不可用时 AAudio 也可能直接降级为共享模式而不报错
+    int32_t opened_tier = STREAM_TIER_OPENSL_ES;
+    if (m_stream->getAudioApi() == oboe::AudioApi::AAudio) {
+        opened_tier = m_stream->getSharingMode() == oboe::SharingMode::Exclusive
+                      ? STREAM_TIER_AAUDIO_EXCLUSIVE
+                      : STREAM_TIER_AAUDIO_SHARED;
+    }
+    
+    m_stream_tier.store(opened_tier);
+    m_mmap_used.store(opened_tier != STREAM_TIER_OPENSL_ES &&
+                      oboe::AAudioExtensions::getInstance().isMMapUsed(m_stream.get()));
+    m_frames_per_burst.store(m_stream->getFramesPerBurst());
+    m_device_sample_rate.store(m_stream->getSampleRate());
+    
+    // 新流的时间戳位置从 0 开始，旧流的计数和时间戳不能再用来推算
+    m_frames_rendered.store(0);
+    ResetTimestamp();
+    
     if (!OptimizeBufferSize()) {
         CloseStream();
         return false;
     }
     
     m_device_channels = m_stream->getChannelCount();
+    m_oboe_format = m_stream->getFormat();
+    m_device_format = MapOboeFormat(m_oboe_format);
+    m_output_converter.Configure(m_sample_format.load(), m_channel_count.load(),
+                                 m_device_format, m_device_channels);
+    m_resampler_input_converter.Configure(m_sample_format.load(), m_channel_count.load(),
+                                          PCM_FLOAT, m_device_channels);
+    m_resampler_output_converter.Configure(PCM_FLOAT, m_device_channels, m_device_format, m_device_channels);
+    m_resampler.Configure(m_device_channels);
+    m_mixer.SetOutputChannels(m_device_channels);
+    m_mixer.SetSampleRate(m_stream->getSampleRate());
+    SelectReadKernel();
+    m_resampler_active = false;
+    m_drift_measuring = false;
+    m_drift_correction_ppm.store(0.0f);
+    m_current_gain = m_volume.load();
+    m_gain_ramp_frames = std::max(1.0f, m_stream->getSampleRate() * GAIN_RAMP_MS / 1000.0f);
     
     result = m_stream->requestStart();
     if (result != oboe::Result::OK) {
@@ -178,10 +311,20 @@ bool OboeAudioRenderer::ConfigureAndOpenStream() {
 bool OboeAudioRenderer::OptimizeBufferSize() {
     if (!m_stream) return false;
     
-    int32_t framesPerBurst = m_stream->getFramesPerBurst();
-    int32_t desired_buffer_size = framesPerBurst > 0 ? framesPerBurst * 2 : 960;
+    // 流尚未启动，这里可以安全地重置回调线程的状态
+    m_latency_controller.Reset(m_stream->getFramesPerBurst(),
+                               m_stream->getBufferCapacityInFrames(),
+                               m_stream->getSampleRate());
     
-    m_stream->setBufferSizeInFrames(desired_buffer_size);
+    auto result = m_stream->setBufferSizeInFrames(m_latency_controller.GetTargetFrames());
+    if (result) {
+        m_latency_controller.OnBufferSizeApplied(result.value());
+    }
+    
+    m_frames_since_latency_check = 0;
+    m_starved_since_latency_check = false;
+    m_latency_target_frames.store(m_latency_controller.GetTargetFrames());
+    m_xrun_count.store(0);
     return true;
 }
 
@@ -201,101 +344,390 @@ void OboeAudioRenderer::CloseStream() {
 }
 
 bool OboeAudioRenderer::TryRestartStream() {
+    AUDIO_TRACE_SCOPE("OboeAudioRenderer::TryRestartStream");
     std::lock_guard<std::mutex> lock(m_stream_mutex);
     
     if (!m_initialized.load()) {
-        return false;
+        m_needs_restart.store(false);
+        return true;
     }
     
+    // 保留缓冲区中的数据，新流启动后从断点继续播放
     CloseStream();
-    ClearAllBuffers();
-    
-    // 等待一小段时间，让系统有机会恢复
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
     
     bool success = ConfigureAndOpenStream();
     
     if (success) {
         m_needs_restart.store(false);
+        m_restart_count.fetch_add(1);
     }
     
     return success;
 }
 
+void OboeAudioRenderer::RequestRestart() {
+    {
+        std::lock_guard<std::mutex> lock(m_recovery_mutex);
+        m_needs_restart.store(true);
+    }
+    m_recovery_cv.notify_one();
+}
+
+void OboeAudioRenderer::RecoveryThreadMain() {
+    std::unique_lock<std::mutex> lock(m_recovery_mutex);
+    int32_t delay_ms = RECOVERY_INITIAL_DELAY_MS;
+    
+    while (!m_recovery_exit) {
+        if (!m_needs_restart.load()) {
+            delay_ms = RECOVERY_INITIAL_DELAY_MS;
+            m_recovery_cv.wait(lock, [this] { return m_recovery_exit || m_needs_restart.load(); });
+            continue;
+        }
+        
+        // 等待一小段时间，让系统有机会恢复
+        if (m_recovery_cv.wait_for(lock, std::chrono::milliseconds(delay_ms), [this] { return m_recovery_exit; })) {
+            break;
+        }
+        
+        lock.unlock();
+        bool success = TryRestartStream();
+        lock.lock();
+        
+        if (!success) {
+            delay_ms = std::min(delay_ms * 2, RECOVERY_MAX_DELAY_MS);
+        }
+    }
+}
+
+void OboeAudioRenderer::SetBackpressurePolicy(int32_t policy, int32_t timeout_ms) {
+    m_backpressure_policy.store(policy == BACKPRESSURE_BLOCK ? BACKPRESSURE_BLOCK : BACKPRESSURE_DROP);
+    m_backpressure_timeout_ms.store(std::max(0, timeout_ms));
+}
+
+bool OboeAudioRenderer::WaitForSpace(std::chrono::steady_clock::time_point& deadline) {
+    // 流正在恢复时没有回调消费数据，等待没有意义
+    if (m_backpressure_policy.load() != BACKPRESSURE_BLOCK || m_needs_restart.load()) {
+        return false;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    if (deadline == std::chrono::steady_clock::time_point{}) {
+        deadline = now + std::chrono::milliseconds(m_backpressure_timeout_ms.load());
+    }
+    
+    if (now >= deadline) {
+        return false;
+    }
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return true;
+}
+
 bool OboeAudioRenderer::WriteAudio(const int16_t* data, int32_t num_frames) {
     if (!m_initialized.load() || !data || num_frames <= 0) return false;
     
-    int32_t system_channels = m_channel_count.load();
-    size_t data_size = num_frames * system_channels * sizeof(int16_t);
     return WriteAudioRaw(reinterpret_cast<const void*>(data), num_frames, PCM_INT16);
 }
 
 bool OboeAudioRenderer::WriteAudioRaw(const void* data, int32_t num_frames, int32_t sampleFormat) {
+    AUDIO_TRACE_SCOPE("OboeAudioRenderer::WriteAudioRaw");
     if (!m_initialized.load() || !data || num_frames <= 0) return false;
     
-    // 检查是否需要重启流
-    if (m_needs_restart.load()) {
-        if (!TryRestartStream()) {
-            return false;
-        }
+    if (sampleFormat < PCM_INT16 || sampleFormat > PCM_FLOAT) {
+        return false;
     }
     
-    // 检查格式是否匹配
+    // 格式与初始化时不一致，先转换再写入
     if (sampleFormat != m_sample_format.load()) {
+        return WriteConverted(data, num_frames, sampleFormat);
+    }
+    
+    if (m_active_buffer_mode == BUFFER_MODE_RING) {
+        const uint8_t* src = static_cast<const uint8_t*>(data);
+        size_t frame_bytes = m_ring_buffer.GetBytesPerFrame();
+        uint32_t frames_done = 0;
+        std::chrono::steady_clock::time_point deadline{};
+        
+        while (true) {
+            uint32_t frames = m_ring_buffer.Write(src + frames_done * frame_bytes,
+                                                  static_cast<uint32_t>(num_frames) - frames_done);
+            m_frames_written.fetch_add(frames, std::memory_order_relaxed);
+            frames_done += frames;
+            if (frames_done == static_cast<uint32_t>(num_frames)) {
+                return true;
+            }
+            
+            // 环形缓冲区满了，按背压策略等待或丢弃剩余数据
+            if (!WaitForSpace(deadline)) {
+                m_overrun_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+    }
+    
+    return WriteToBlockQueue(data, num_frames, sampleFormat);
+}
+
+int32_t OboeAudioRenderer::OpenInput(int32_t channelCount, int32_t sampleFormat) {
+    if (!m_initialized.load()) return -1;
+    
+    uint32_t capacity = static_cast<uint32_t>(m_sample_rate.load() * RING_BUFFER_MS / 1000);
+    return m_mixer.OpenInput(channelCount, sampleFormat, capacity);
+}
+
+bool OboeAudioRenderer::RegisterSubmitBuffers(void* data, size_t data_size, void* descriptors, size_t descriptors_size) {
+    if (!data || data_size == 0 || !descriptors || descriptors_size < sizeof(SubmitDescriptor)) {
+        return false;
+    }
+    
+    if (reinterpret_cast<uintptr_t>(descriptors) % alignof(SubmitDescriptor) != 0) {
         return false;
     }
     
-    int32_t system_channels = m_channel_count.load();
-    size_t bytes_per_sample = GetBytesPerSample(sampleFormat);
-    size_t total_bytes = num_frames * system_channels * bytes_per_sample;
+    m_submit_data = static_cast<const uint8_t*>(data);
+    m_submit_data_size = data_size;
+    m_submit_descriptors = static_cast<const SubmitDescriptor*>(descriptors);
+    m_submit_descriptor_capacity = static_cast<int32_t>(descriptors_size / sizeof(SubmitDescriptor));
+    return true;
+}
+
+void OboeAudioRenderer::UnregisterSubmitBuffers() {
+    m_submit_data = nullptr;
+    m_submit_data_size = 0;
+    m_submit_descriptors = nullptr;
+    m_submit_descriptor_capacity = 0;
+}
+
+int32_t OboeAudioRenderer::SubmitRegistered(int32_t count) {
+    if (!m_submit_descriptors) return 0;
+    return SubmitBatch(m_submit_descriptors, std::min(count, m_submit_descriptor_capacity));
+}
+
+int32_t OboeAudioRenderer::SubmitBatch(const SubmitDescriptor* descriptors, int32_t count) {
+    if (!m_submit_data || !descriptors || count <= 0) return 0;
+    
+    for (int32_t i = 0; i < count; ++i) {
+        // 托管代码随时可能改写共享的描述符，先复制一份，校验和使用都只看这份副本
+        const SubmitDescriptor desc = descriptors[i];
+        
+        size_t frame_bytes;
+        if (desc.input_id < 0) {
+            if (desc.sample_format < PCM_INT16 || desc.sample_format > PCM_FLOAT) return i;
+            frame_bytes = m_channel_count.load() * GetBytesPerSample(desc.sample_format);
+        } else {
+            frame_bytes = static_cast<size_t>(m_mixer.GetFrameBytes(desc.input_id));
+        }
+        
+        // 描述符来自托管代码，越界的直接拒绝
+        if (frame_bytes == 0 || desc.offset < 0 || desc.frames <= 0 ||
+            static_cast<size_t>(desc.offset) + static_cast<size_t>(desc.frames) * frame_bytes > m_submit_data_size) {
+            return i;
+        }
+        
+        const void* data = m_submit_data + desc.offset;
+        bool written = desc.input_id < 0
+                       ? WriteAudioRaw(data, desc.frames, desc.sample_format)
+                       : m_mixer.Write(desc.input_id, data, desc.frames);
+        if (!written) {
+            return i;
+        }
+    }
+    
+    return count;
+}
+
+bool OboeAudioRenderer::WriteConverted(const void* data, int32_t num_frames, int32_t sampleFormat) {
+    int32_t channels = m_channel_count.load();
+    int32_t target_format = m_sample_format.load();
+    m_input_converter.Configure(sampleFormat, channels, target_format, channels);
+    
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    size_t src_frame_bytes = m_input_converter.GetSourceFrameBytes();
+    
+    if (m_active_buffer_mode == BUFFER_MODE_RING) {
+        // 直接转换到环形缓冲区里，不经过中间缓冲
+        int32_t frames_done = 0;
+        std::chrono::steady_clock::time_point deadline{};
+        
+        while (frames_done < num_frames) {
+            void* region = nullptr;
+            uint32_t frames = m_ring_buffer.AcquireWrite(&region, static_cast<uint32_t>(num_frames - frames_done));
+            if (frames == 0) {
+                if (!WaitForSpace(deadline)) {
+                    m_overrun_count.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                continue;
+            }
+            
+            m_input_converter.Convert(src + frames_done * src_frame_bytes, region, static_cast<int32_t>(frames));
+            m_ring_buffer.CommitWrite(frames);
+            m_frames_written.fetch_add(frames, std::memory_order_relaxed);
+            frames_done += static_cast<int32_t>(frames);
+        }
+        return true;
+    }
+    
+    m_input_scratch.resize(static_cast<size_t>(num_frames) * m_input_converter.GetDestinationFrameBytes());
+    m_input_converter.Convert(data, m_input_scratch.data(), num_frames);
+    return WriteToBlockQueue(m_input_scratch.data(), num_frames, target_format);
+}
+
+WriteRegion OboeAudioRenderer::BeginWrite(int32_t max_frames) {
+    WriteRegion region;
+    m_pending_write_frames = 0;
+    
+    if (!m_initialized.load() || max_frames <= 0 || m_active_buffer_mode != BUFFER_MODE_RING) {
+        return region;
+    }
+    
+    region.frames = static_cast<int32_t>(m_ring_buffer.AcquireWrite(&region.data, static_cast<uint32_t>(max_frames)));
+    m_pending_write_frames = region.frames;
+    return region;
+}
+
+bool OboeAudioRenderer::CommitWrite(int32_t num_frames) {
+    if (num_frames < 0 || num_frames > m_pending_write_frames) {
+        m_pending_write_frames = 0;
+        return false;
+    }
+    
+    if (num_frames > 0) {
+        m_ring_buffer.CommitWrite(static_cast<uint32_t>(num_frames));
+        m_frames_written.fetch_add(num_frames, std::memory_order_relaxed);
+    }
+    
+    m_pending_write_frames = 0;
+    return true;
+}
+
+bool OboeAudioRenderer::WriteToBlockQueue(const void* data, int32_t num_frames, int32_t sampleFormat) {
+    size_t frame_bytes = m_channel_count.load() * GetBytesPerSample(sampleFormat);
+    // 每块只放整帧：部分写入时按帧计数不会丢帧或重复计数，回调也可以直接在块内转换
+    int32_t frames_per_block = static_cast<int32_t>(AudioBlock::BLOCK_SIZE / frame_bytes);
     
     const uint8_t* byte_data = static_cast<const uint8_t*>(data);
-    size_t bytes_remaining = total_bytes;
-    size_t bytes_processed = 0;
+    int32_t frames_done = 0;
+    std::chrono::steady_clock::time_point deadline{};
     
-    while (bytes_remaining > 0) {
+    auto on_overrun = [&]() {
+        m_frames_written.fetch_add(frames_done, std::memory_order_relaxed);
+        m_overrun_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    };
+    
+    while (frames_done < num_frames) {
+        // 队列满了，按背压策略等待或丢弃剩余数据
+        while (m_audio_queue.size() >= AUDIO_QUEUE_SIZE) {
+            if (!WaitForSpace(deadline)) {
+                return on_overrun();
+            }
+        }
+        
         auto block = AcquireBlock();
-        if (!block) return false;
+        if (!block) return on_overrun();
         
-        size_t copy_size = std::min(bytes_remaining, AudioBlock::BLOCK_SIZE);
-        std::memcpy(block->data, byte_data + bytes_processed, copy_size);
+        int32_t frames = std::min(num_frames - frames_done, frames_per_block);
+        size_t copy_size = static_cast<size_t>(frames) * frame_bytes;
+        std::memcpy(block->data, byte_data + static_cast<size_t>(frames_done) * frame_bytes, copy_size);
         
         block->data_size = copy_size;
         block->data_played = 0;
         block->sample_format = sampleFormat;
         block->consumed = false;
         
+        // 入队失败时不能归还到空闲队列（生产者不是它的写入者），留到下一次使用
         if (!m_audio_queue.push(std::move(block))) {
-            // 队列满了，尝试重启
-            m_needs_restart.store(true);
-            return false;
+            if (block) {
+                block->clear();
+                m_spare_block = std::move(block);
+            }
+            return on_overrun();
         }
         
-        bytes_processed += copy_size;
-        bytes_remaining -= copy_size;
+        frames_done += frames;
     }
     
+    m_frames_written.fetch_add(num_frames, std::memory_order_relaxed);
     return true;
 }
 
+bool OboeAudioRenderer::IsPlaying() const {
+    std::lock_guard<std::mutex> lock(m_stream_mutex);
+    return m_stream && m_stream->getState() == oboe::StreamState::Started;
+}
+
 int32_t OboeAudioRenderer::GetBufferedFrames() const {
     if (!m_initialized.load()) return 0;
     
-    int32_t total_frames = 0;
-    int32_t device_channels = m_device_channels;
+    // 只读取原子计数，不访问回调线程持有的块
+    int64_t played = m_frames_played.load(std::memory_order_acquire) + m_frames_discarded.load(std::memory_order_acquire);
+    int64_t buffered = m_frames_written.load(std::memory_order_acquire) - played;
+    return static_cast<int32_t>(std::max<int64_t>(0, buffered));
+}
+
+void OboeAudioRenderer::GetStats(AudioStats& stats) const {
+    stats.frames_written = m_frames_written.load(std::memory_order_acquire);
+    stats.frames_played = m_frames_played.load(std::memory_order_acquire);
+    stats.buffered_frames = GetBufferedFrames();
+    stats.underrun_count = m_underrun_count.load(std::memory_order_relaxed);
+    stats.overrun_count = m_overrun_count.load(std::memory_order_relaxed);
+    stats.xrun_count = m_xrun_count.load(std::memory_order_relaxed);
+    stats.drift_correction_ppm = m_drift_correction_ppm.load(std::memory_order_relaxed);
     
-    if (m_current_block && !m_current_block->consumed) {
-        size_t bytes_remaining = m_current_block->available();
-        size_t bytes_per_sample = GetBytesPerSample(m_current_block->sample_format);
-        total_frames += static_cast<int32_t>(bytes_remaining / (device_channels * bytes_per_sample));
+    stats.callback_count = m_callback_count.load(std::memory_order_relaxed);
+    stats.callback_min_ns = m_callback_min_ns.load(std::memory_order_relaxed);
+    stats.callback_max_ns = m_callback_max_ns.load(std::memory_order_relaxed);
+    stats.callback_avg_ns = stats.callback_count > 0
+                            ? m_callback_total_ns.load(std::memory_order_relaxed) / stats.callback_count
+                            : 0;
+    
+    if (!ReadTimestamp(stats.timestamp_position, stats.timestamp_ns)) {
+        stats.timestamp_position = 0;
+        stats.timestamp_ns = 0;
     }
+}
+
+int64_t OboeAudioRenderer::GetNextWritePresentationTimeNs() const {
+    if (!m_initialized.load()) return 0;
+    
+    int32_t sample_rate = m_sample_rate.load();
+    int32_t device_rate = m_device_sample_rate.load();
+    if (sample_rate <= 0 || device_rate <= 0) return 0;
     
-    uint32_t queue_size = m_audio_queue.size();
-    size_t bytes_per_sample = GetBytesPerSample(m_sample_format.load());
-    int32_t frames_per_block = static_cast<int32_t>(AudioBlock::BLOCK_SIZE / (device_channels * bytes_per_sample));
-    total_frames += queue_size * frames_per_block;
+    // 时间戳位置和 m_frames_rendered 都是设备采样率下的帧数，
+    // 缓冲区里的是源采样率下的帧数，先换算到设备采样率
+    int64_t buffered = static_cast<int64_t>(GetBufferedFrames()) * device_rate / sample_rate;
     
-    return total_frames;
+    // 下一帧写入的数据排在当前缓冲区之后
+    int64_t next_frame = m_frames_rendered.load(std::memory_order_acquire) + buffered;
+    
+    int64_t position = 0;
+    int64_t time_ns = 0;
+    if (ReadTimestamp(position, time_ns)) {
+        return time_ns + (next_frame - position) * 1000000000LL / device_rate;
+    }
+    
+    // 没有时间戳（OpenSL ES 或流刚启动）时，假设设备缓冲区保持在目标大小
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t queued = buffered + m_latency_target_frames.load();
+    return now_ns + queued * 1000000000LL / device_rate;
+}
+
+void OboeAudioRenderer::ResetStats() {
+    m_frames_written.store(0);
+    m_frames_played.store(0);
+    m_frames_discarded.store(0);
+    m_frames_rendered.store(0);
+    m_underrun_count.store(0);
+    m_overrun_count.store(0);
+    m_callback_count.store(0);
+    m_callback_total_ns.store(0);
+    m_callback_min_ns.store(0);
+    m_callback_max_ns.store(0);
+    m_was_starved = false;
+    ResetTimestamp();
 }
 
 void OboeAudioRenderer::SetVolume(float volume) {
@@ -307,7 +739,6 @@ void OboeAudioRenderer::Reset() {
     
     ClearAllBuffers();
     
-    CloseStream();
     ConfigureAndOpenStream();
 }
 
@@ -321,27 +752,329 @@ oboe::AudioFormat OboeAudioRenderer::MapSampleFormat(int32_t format) {
     }
 }
 
-size_t OboeAudioRenderer::GetBytesPerSample(int32_t format) {
+int32_t OboeAudioRenderer::MapOboeFormat(oboe::AudioFormat format) {
     switch (format) {
-        case PCM_INT16:  return 2;
-        case PCM_INT24:  return 3;
-        case PCM_INT32:  return 4;
-        case PCM_FLOAT:  return 4;
-        default:         return 2;
+        case oboe::AudioFormat::I16:    return PCM_INT16;
+        case oboe::AudioFormat::I24:    return PCM_INT24;
+        case oboe::AudioFormat::I32:    return PCM_INT32;
+        case oboe::AudioFormat::Float:  return PCM_FLOAT;
+        default:                        return PCM_FLOAT;
     }
 }
 
+size_t OboeAudioRenderer::GetBytesPerSample(int32_t format) {
+    return AudioFormatConverter::GetBytesPerSample(format);
+}
+
 oboe::DataCallbackResult OboeAudioRenderer::OnAudioReady(oboe::AudioStream* audioStream, void* audioData, int32_t num_frames) {
+    AUDIO_TRACE_SCOPE("OboeAudioRenderer::OnAudioReady");
     if (!m_initialized.load() || !audioStream || !audioData) {
         return oboe::DataCallbackResult::Continue;
     }
     
-    int32_t device_channels = m_device_channels;
-    size_t bytes_per_sample = GetBytesPerSample(m_sample_format.load());
-    size_t bytes_needed = num_frames * device_channels * bytes_per_sample;
+    // 读取前的填充量，和回调线程的调度放在一起看就能分辨欠载原因
+    AUDIO_TRACE_COUNTER("AudioBufferedFrames", GetBufferedFrames());
+    
+    auto callback_start = std::chrono::steady_clock::now();
+    
+    // 重建流后回调线程会变化，每个新线程调整一次亲和性和性能提示
+    int32_t tid = static_cast<int32_t>(gettid());
+    if (tid != m_callback_thread_id.load(std::memory_order_relaxed)) {
+        m_callback_thread_id.store(tid, std::memory_order_relaxed);
+        int32_t device_rate = audioStream->getSampleRate();
+        if (setAudioCallbackThread && device_rate > 0) {
+            setAudioCallbackThread(tid, static_cast<long>(static_cast<int64_t>(num_frames) * 1000000000LL / device_rate));
+        }
+    }
+    
+    float gain = 1.0f;
+    float gain_step = 0.0f;
+    UpdateGainRamp(num_frames, gain, gain_step);
+    
+    int32_t frames_read;
+    int32_t frames_consumed = -1;
+    if (m_active_buffer_mode == BUFFER_MODE_RING && m_drift_compensation.load(std::memory_order_relaxed)) {
+        if (!m_drift_measuring) {
+            m_drift_detector.Reset(m_sample_rate.load());
+            m_drift_measuring = true;
+        }
+        
+        // 用读取前的填充量判断和驱动比例，欠载时不算作漂移。
+        // 测到持续漂移之前一直走直通和专用读取函数，之后本次流内不再退回
+        int32_t fill = static_cast<int32_t>(m_ring_buffer.AvailableToRead());
+        bool starved = fill < num_frames;
+        if (m_drift_detector.Update(fill, num_frames, starved)) {
+            if (!m_resampler_active) {
+                m_resampler.Reset();
+                m_drift_controller.Reset(m_sample_rate.load());
+                m_resampler_active = true;
+            }
+            
+            m_drift_ratio = m_drift_controller.Update(fill, num_frames, starved);
+            m_drift_correction_ppm.store(static_cast<float>(m_drift_controller.GetCorrectionPpm()), std::memory_order_relaxed);
+            
+            frames_read = ReadResampled(audioData, num_frames, gain, gain_step, frames_consumed);
+        } else {
+            frames_read = (this->*m_read_kernel)(audioData, num_frames, gain, gain_step);
+        }
+    } else {
+        m_drift_measuring = false;
+        frames_read = (this->*m_read_kernel)(audioData, num_frames, gain, gain_step);
+    }
+    
+    if (frames_consumed < 0) {
+        m_resampler_active = false;
+        frames_consumed = frames_read;
+    }
+    
+    // 其它输入叠加到主输入之上，共用主音量
+    if (m_mixer.HasActiveInputs()) {
+        m_mixer.MixInto(audioData, m_device_format, num_frames, gain, gain_step);
+    }
+    
+    UpdateLatency(audioStream, num_frames, frames_read < num_frames);
+    
+    int64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - callback_start).count();
+    UpdateCallbackStats(audioStream, num_frames, frames_read, frames_consumed, duration_ns);
+    if (reportAudioCallbackDuration) {
+        reportAudioCallbackDuration(static_cast<long>(duration_ns));
+    }
+    AUDIO_TRACE_COUNTER("AudioUnderruns", m_underrun_count.load(std::memory_order_relaxed));
+    
+    return oboe::DataCallbackResult::Continue;
+}
+
+void OboeAudioRenderer::UpdateCallbackStats(oboe::AudioStream* audioStream, int32_t num_frames, int32_t frames_read,
+                                            int32_t frames_consumed, int64_t duration_ns) {
+    // 回调线程是唯一的写入者，不需要 CAS
+    m_frames_played.store(m_frames_played.load(std::memory_order_relaxed) + frames_consumed, std::memory_order_release);
+    m_frames_rendered.store(m_frames_rendered.load(std::memory_order_relaxed) + num_frames, std::memory_order_release);
+    
+    // 只统计进入欠载的次数，生产者还没开始写入时不算
+    bool starved = frames_read < num_frames;
+    if (starved && !m_was_starved && m_frames_written.load(std::memory_order_relaxed) > 0) {
+        int32_t underruns = m_underrun_count.load(std::memory_order_relaxed) + 1;
+        m_underrun_count.store(underruns, std::memory_order_relaxed);
+        if (postNativeEvent) {
+            postNativeEvent(NATIVE_EVENT_AUDIO_UNDERRUNS, underruns);
+        }
+    }
+    m_was_starved = starved;
+    
+    int64_t count = m_callback_count.load(std::memory_order_relaxed);
+    int64_t min_ns = m_callback_min_ns.load(std::memory_order_relaxed);
+    int64_t max_ns = m_callback_max_ns.load(std::memory_order_relaxed);
+    if (count == 0 || duration_ns < min_ns) {
+        m_callback_min_ns.store(duration_ns, std::memory_order_relaxed);
+    }
+    if (duration_ns > max_ns) {
+        m_callback_max_ns.store(duration_ns, std::memory_order_relaxed);
+    }
+    m_callback_total_ns.store(m_callback_total_ns.load(std::memory_order_relaxed) + duration_ns, std::memory_order_relaxed);
+    m_callback_count.store(count + 1, std::memory_order_relaxed);
+    
+    m_frames_since_timestamp += num_frames;
+    if (m_frames_since_timestamp >= m_device_sample_rate.load() / TIMESTAMP_UPDATES_PER_SECOND) {
+        m_frames_since_timestamp = 0;
+        PublishTimestamp(audioStream);
+    }
+}
+
+void OboeAudioRenderer::PublishTimestamp(oboe::AudioStream* audioStream) {
+    // OpenSL ES 不支持时间戳
+    auto result = audioStream->getTimestamp(CLOCK_MONOTONIC);
+    if (!result) {
+        return;
+    }
+    
+    uint32_t sequence = m_timestamp_sequence.load(std::memory_order_relaxed);
+    m_timestamp_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_timestamp_position.store(result.value().position, std::memory_order_relaxed);
+    m_timestamp_ns.store(result.value().timestamp, std::memory_order_relaxed);
+    m_timestamp_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void OboeAudioRenderer::ResetTimestamp() {
+    m_frames_since_timestamp = 0;
+    
+    uint32_t sequence = m_timestamp_sequence.load(std::memory_order_relaxed);
+    m_timestamp_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_timestamp_position.store(0, std::memory_order_relaxed);
+    m_timestamp_ns.store(0, std::memory_order_relaxed);
+    m_timestamp_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool OboeAudioRenderer::ReadTimestamp(int64_t& position, int64_t& time_ns) const {
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        uint32_t begin = m_timestamp_sequence.load(std::memory_order_acquire);
+        if (begin & 1) {
+            continue;
+        }
+        
+        position = m_timestamp_position.load(std::memory_order_relaxed);
+        time_ns = m_timestamp_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        if (m_timestamp_sequence.load(std::memory_order_relaxed) == begin) {
+            return time_ns != 0;
+        }
+    }
+    
+    return false;
+}
+
+void OboeAudioRenderer::UpdateLatency(oboe::AudioStream* audioStream, int32_t num_frames, bool starved) {
+    m_frames_since_latency_check += num_frames;
+    m_starved_since_latency_check = m_starved_since_latency_check || starved;
+    
+    if (m_frames_since_latency_check < m_sample_rate.load() / LATENCY_CHECKS_PER_SECOND) {
+        return;
+    }
+    
+    // OpenSL ES 不支持 xrun 计数，此时只会保持初始大小
+    auto xruns = audioStream->getXRunCount();
+    int32_t xrun_count = xruns ? xruns.value() : 0;
+    
+    int32_t target = m_latency_controller.Update(xrun_count, m_starved_since_latency_check,
+                                                 m_frames_since_latency_check);
+    if (target > 0) {
+        auto result = audioStream->setBufferSizeInFrames(target);
+        if (result) {
+            m_latency_controller.OnBufferSizeApplied(result.value());
+        }
+    }
+    
+    m_latency_target_frames.store(m_latency_controller.GetTargetFrames());
+    m_xrun_count.store(xrun_count);
+    AUDIO_TRACE_COUNTER("AudioXRuns", xrun_count);
+    AUDIO_TRACE_COUNTER("AudioBufferTargetFrames", m_latency_controller.GetTargetFrames());
+    m_frames_since_latency_check = 0;
+    m_starved_since_latency_check = false;
+}
+
+int32_t OboeAudioRenderer::ReadFromRing(void* audioData, int32_t num_frames) {
+    size_t bytes_per_frame = m_ring_buffer.GetBytesPerFrame();
+    uint32_t frames_read = m_ring_buffer.Read(audioData, static_cast<uint32_t>(num_frames));
+    
+    // 只需要把欠载的部分填充为静音
+    if (frames_read < static_cast<uint32_t>(num_frames)) {
+        std::memset(static_cast<uint8_t*>(audioData) + frames_read * bytes_per_frame, 0,
+                    (num_frames - frames_read) * bytes_per_frame);
+    }
+    
+    return static_cast<int32_t>(frames_read);
+}
+
+void OboeAudioRenderer::UpdateGainRamp(int32_t num_frames, float& gain, float& gain_step) {
+    float target = m_volume.load(std::memory_order_relaxed);
+    gain = m_current_gain;
+    gain_step = 0.0f;
+    
+    if (gain == target || num_frames <= 0) {
+        return;
+    }
+    
+    // 线性渐变，满幅变化需要 GAIN_RAMP_MS，避免拉链噪声
+    float max_delta = static_cast<float>(num_frames) / m_gain_ramp_frames;
+    float delta = std::clamp(target - gain, -max_delta, max_delta);
+    
+    gain_step = delta / static_cast<float>(num_frames);
+    m_current_gain = std::abs(target - (gain + delta)) < 1e-6f ? target : gain + delta;
+}
+
+int32_t OboeAudioRenderer::ReadConverted(void* audioData, int32_t num_frames, float gain, float gain_step) {
+    uint8_t* output = static_cast<uint8_t*>(audioData);
+    size_t dst_frame_bytes = m_output_converter.GetDestinationFrameBytes();
+    int32_t frames_done = 0;
+    
+    while (frames_done < num_frames) {
+        int32_t wanted = std::min(num_frames - frames_done, AudioFormatConverter::CHUNK_FRAMES);
+        int32_t frames = 0;
+        
+        if (m_active_buffer_mode == BUFFER_MODE_RING) {
+            // 直接从环形缓冲区转换到输出
+            const void* region = nullptr;
+            frames = static_cast<int32_t>(m_ring_buffer.AcquireRead(&region, static_cast<uint32_t>(wanted)));
+            if (frames > 0) {
+                m_output_converter.Convert(region, output + frames_done * dst_frame_bytes, frames,
+                                           gain + gain_step * frames_done, gain_step);
+                m_ring_buffer.CommitRead(static_cast<uint32_t>(frames));
+            }
+        } else {
+            // 一次读取可能跨越多个块，先拼接到临时缓冲区
+            frames = ReadFromBlockQueue(m_conversion_scratch, wanted);
+            if (frames > 0) {
+                m_output_converter.Convert(m_conversion_scratch, output + frames_done * dst_frame_bytes, frames,
+                                           gain + gain_step * frames_done, gain_step);
+            }
+        }
+        
+        if (frames == 0) {
+            break;
+        }
+        
+        frames_done += frames;
+    }
+    
+    if (frames_done < num_frames) {
+        std::memset(output + frames_done * dst_frame_bytes, 0, (num_frames - frames_done) * dst_frame_bytes);
+    }
+    
+    return frames_done;
+}
+
+int32_t OboeAudioRenderer::ReadResampled(void* audioData, int32_t num_frames, float gain, float gain_step,
+                                         int32_t& frames_consumed) {
+    uint8_t* output = static_cast<uint8_t*>(audioData);
+    size_t dst_frame_bytes = m_resampler_output_converter.GetDestinationFrameBytes();
+    int32_t channels = m_resampler.GetChannelCount();
+    int32_t frames_done = 0;
+    frames_consumed = 0;
+    
+    while (frames_done < num_frames) {
+        int32_t wanted = std::min(num_frames - frames_done, AudioResampler::MAX_OUTPUT_FRAMES);
+        int32_t needed = m_resampler.GetInputFramesNeeded(wanted, m_drift_ratio);
+        float* input = m_resampler.GetInputBuffer();
+        
+        // 输入可能跨越环绕点，分两段解码到重采样器的输入缓冲区
+        int32_t input_frames = 0;
+        while (input_frames < needed) {
+            const void* region = nullptr;
+            uint32_t frames = m_ring_buffer.AcquireRead(&region, static_cast<uint32_t>(needed - input_frames));
+            if (frames == 0) {
+                break;
+            }
+            
+            m_resampler_input_converter.Convert(region, input + input_frames * channels, static_cast<int32_t>(frames));
+            m_ring_buffer.CommitRead(frames);
+            input_frames += static_cast<int32_t>(frames);
+        }
+        frames_consumed += input_frames;
+        
+        int32_t produced = m_resampler.Process(input_frames, m_resampler_output, wanted, m_drift_ratio);
+        m_resampler_output_converter.Convert(m_resampler_output, output + frames_done * dst_frame_bytes, produced,
+                                             gain + gain_step * frames_done, gain_step);
+        frames_done += produced;
+        
+        if (produced < wanted) {
+            break;
+        }
+    }
+    
+    if (frames_done < num_frames) {
+        std::memset(output + frames_done * dst_frame_bytes, 0, (num_frames - frames_done) * dst_frame_bytes);
+    }
     
-    // 先清空输出缓冲区
-    std::memset(audioData, 0, bytes_needed);
+    return frames_done;
+}
+
+int32_t OboeAudioRenderer::ReadFromBlockQueue(void* audioData, int32_t num_frames) {
+    // 读出的是队列中的原始格式，与设备格式一致时才会直接写到回调缓冲区
+    size_t bytes_per_frame = m_output_converter.GetSourceFrameBytes();
+    size_t bytes_needed = num_frames * bytes_per_frame;
     
     uint8_t* output = static_cast<uint8_t*>(audioData);
     size_t bytes_copied = 0;
@@ -353,7 +1086,7 @@ oboe::DataCallbackResult OboeAudioRenderer::OnAudioReady(oboe::AudioStream* audi
             }
             
             if (!m_audio_queue.pop(m_current_block)) {
-                // 没有更多数据了，跳出循环（剩余部分已经是静音）
+                // 没有更多数据了，剩余部分在循环后填充静音
                 break;
             }
         }
@@ -384,15 +1117,149 @@ oboe::DataCallbackResult OboeAudioRenderer::OnAudioReady(oboe::AudioStream* audi
         }
     }
     
-    return oboe::DataCallbackResult::Continue;
+    if (bytes_copied < bytes_needed) {
+        std::memset(output + bytes_copied, 0, bytes_needed - bytes_copied);
+    }
+    
+    return static_cast<int32_t>(bytes_copied / bytes_per_frame);
 }
 
-void OboeAudioRenderer::OnStreamErrorAfterClose(oboe::AudioStream* audioStream, oboe::Result error) {
-    // 标记需要重启流
-    m_needs_restart.store(true);
+size_t OboeAudioRenderer::AcquireBlockRead(const uint8_t** region, size_t max_bytes, int32_t sample_format) {
+    while (!m_current_block || m_current_block->consumed || m_current_block->available() == 0) {
+        if (m_current_block) {
+            ReleaseBlock(std::move(m_current_block));
+        }
+        
+        if (!m_audio_queue.pop(m_current_block)) {
+            return 0;
+        }
+        
+        // 格式只在取到新块时检查一次，不匹配的块直接丢弃
+        if (m_current_block->sample_format != sample_format) {
+            ReleaseBlock(std::move(m_current_block));
+        }
+    }
+    
+    *region = m_current_block->data + m_current_block->data_played;
+    return std::min(m_current_block->available(), max_bytes);
+}
+
+int32_t OboeAudioRenderer::ReadKernelGeneric(void* audioData, int32_t num_frames, float gain, float gain_step) {
+    // 格式一致且增益为 1 时直接拷贝，否则增益与格式转换合并为一次遍历
+    if (!m_output_converter.IsPassthrough() || gain != 1.0f || gain_step != 0.0f) {
+        return ReadConverted(audioData, num_frames, gain, gain_step);
+    }
+    
+    if (m_active_buffer_mode == BUFFER_MODE_RING) {
+        return ReadFromRing(audioData, num_frames);
+    }
+    
+    return ReadFromBlockQueue(audioData, num_frames);
+}
+
+template <typename SrcT, int32_t SrcChannels, typename DstT, bool Ring>
+int32_t OboeAudioRenderer::ReadKernelSpecialized(void* audioData, int32_t num_frames, float gain, float gain_step) {
+    // 设备固定为立体声，见 SelectReadKernel
+    constexpr size_t SRC_FRAME_BYTES = sizeof(SrcT) * SrcChannels;
+    constexpr bool SAME_LAYOUT = std::is_same_v<SrcT, DstT> && SrcChannels == 2;
+    
+    DstT* output = static_cast<DstT*>(audioData);
+    bool unity_gain = gain == 1.0f && gain_step == 0.0f;
+    int32_t frames_done = 0;
+    
+    while (frames_done < num_frames) {
+        const void* region = nullptr;
+        int32_t frames;
+        if constexpr (Ring) {
+            frames = static_cast<int32_t>(m_ring_buffer.AcquireRead(&region, static_cast<uint32_t>(num_frames - frames_done)));
+        } else {
+            const uint8_t* bytes = nullptr;
+            frames = static_cast<int32_t>(AcquireBlockRead(&bytes, (num_frames - frames_done) * SRC_FRAME_BYTES,
+                                                           SampleFormatOf<SrcT>()) / SRC_FRAME_BYTES);
+            region = bytes;
+        }
+        
+        if (frames == 0) {
+            break;
+        }
+        
+        DstT* dst = output + static_cast<size_t>(frames_done) * 2;
+        float chunk_gain = gain + gain_step * static_cast<float>(frames_done);
+        if (SAME_LAYOUT && unity_gain) {
+            std::memcpy(dst, region, static_cast<size_t>(frames) * SRC_FRAME_BYTES);
+        } else if constexpr (SrcChannels == 2) {
+            ConvertStereo(static_cast<const SrcT*>(region), dst, frames, chunk_gain, gain_step);
+        } else {
+            // 5.1 下混使用转换器里的 NEON 实现
+            m_output_converter.Convert(region, dst, frames, chunk_gain, gain_step);
+        }
+        
+        if constexpr (Ring) {
+            m_ring_buffer.CommitRead(static_cast<uint32_t>(frames));
+        } else {
+            m_current_block->data_played += static_cast<size_t>(frames) * SRC_FRAME_BYTES;
+            if (m_current_block->available() == 0) {
+                m_current_block->consumed = true;
+            }
+        }
+        
+        frames_done += frames;
+    }
+    
+    // 只把欠载的部分填充为静音
+    if (frames_done < num_frames) {
+        std::memset(output + static_cast<size_t>(frames_done) * 2, 0,
+                    static_cast<size_t>(num_frames - frames_done) * 2 * sizeof(DstT));
+    }
+    
+    return frames_done;
+}
+
+template <typename DstT>
+OboeAudioRenderer::ReadKernel OboeAudioRenderer::SelectReadKernelFor(int32_t sample_format, int32_t channels, bool ring) {
+    if (sample_format == PCM_INT16 && channels == 2) {
+        return ring ? &OboeAudioRenderer::ReadKernelSpecialized<int16_t, 2, DstT, true>
+                    : &OboeAudioRenderer::ReadKernelSpecialized<int16_t, 2, DstT, false>;
+    }
+    if (sample_format == PCM_INT16 && channels == 6) {
+        return ring ? &OboeAudioRenderer::ReadKernelSpecialized<int16_t, 6, DstT, true>
+                    : &OboeAudioRenderer::ReadKernelSpecialized<int16_t, 6, DstT, false>;
+    }
+    if (sample_format == PCM_FLOAT && channels == 2) {
+        return ring ? &OboeAudioRenderer::ReadKernelSpecialized<float, 2, DstT, true>
+                    : &OboeAudioRenderer::ReadKernelSpecialized<float, 2, DstT, false>;
+    }
+    if (sample_format == PCM_FLOAT && channels == 6) {
+        return ring ? &OboeAudioRenderer::ReadKernelSpecialized<float, 6, DstT, true>
+                    : &OboeAudioRenderer::ReadKernelSpecialized<float, 6, DstT, false>;
+    }
+    return &OboeAudioRenderer::ReadKernelGeneric;
+}
+
+void OboeAudioRenderer::SelectReadKernel() {
+    // 流还没启动，回调线程不会同时读取 m_read_kernel
+    m_read_kernel = &OboeAudioRenderer::ReadKernelGeneric;
+    if (m_device_channels != 2) {
+        return;
+    }
+    
+    int32_t sample_format = m_sample_format.load();
+    int32_t channels = m_channel_count.load();
+    bool ring = m_active_buffer_mode == BUFFER_MODE_RING;
+    
+    if (m_device_format == PCM_INT16) {
+        m_read_kernel = SelectReadKernelFor<int16_t>(sample_format, channels, ring);
+    } else if (m_device_format == PCM_FLOAT) {
+        m_read_kernel = SelectReadKernelFor<float>(sample_format, channels, ring);
+    }
+}
+
+void OboeAudioRenderer::OnStreamErrorAfterClose(oboe::AudioStream* /*audioStream*/, oboe::Result /*error*/) {
+    // 交给恢复线程重建流
+    RequestRestart();
 }
 
-void OboeAudioRenderer::OnStreamErrorBeforeClose(oboe::AudioStream* audioStream, oboe::Result error) {
+void OboeAudioRenderer::OnStreamErrorBeforeClose(oboe::AudioStream* /*audioStream*/, oboe::Result /*error*/) {
     m_stream_started.store(false);
     m_needs_restart.store(true);
 }
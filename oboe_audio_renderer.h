@@ -3,18 +3,38 @@
 
 #include <oboe/Oboe.h>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <cstdint>
 #include "LockFreeQueue.h"
+#include "audio_ring_buffer.h"
+#include "audio_latency_controller.h"
+#include "audio_format_converter.h"
+#include "audio_resampler.h"
+#include "audio_drift_controller.h"
+#include "audio_mixer.h"
 
 namespace RyujinxOboe {
 
-enum SampleFormat {
-    PCM_INT16 = 1,
-    PCM_INT24 = 2,
-    PCM_INT32 = 3,
-    PCM_FLOAT = 4
+enum StreamTier {
+    STREAM_TIER_NONE = 0,
+    STREAM_TIER_AAUDIO_EXCLUSIVE = 1,
+    STREAM_TIER_AAUDIO_SHARED = 2,
+    STREAM_TIER_OPENSL_ES = 3
+};
+
+enum BackpressurePolicy {
+    BACKPRESSURE_DROP = 0,
+    BACKPRESSURE_BLOCK = 1
+};
+
+enum BufferMode {
+    BUFFER_MODE_BLOCK_QUEUE = 0,
+    BUFFER_MODE_RING = 1
 };
 
 struct AudioBlock {
@@ -37,6 +57,38 @@ struct AudioBlock {
     }
 };
 
+// 所有字段来自各线程原子发布的计数，读取时不加锁
+struct AudioStats {
+    int64_t frames_written = 0;
+    int64_t frames_played = 0;
+    int32_t buffered_frames = 0;
+    int32_t underrun_count = 0;
+    int32_t overrun_count = 0;
+    int32_t xrun_count = 0;
+    int64_t callback_count = 0;
+    int64_t callback_min_ns = 0;
+    int64_t callback_avg_ns = 0;
+    int64_t callback_max_ns = 0;
+    // getTimestamp(CLOCK_MONOTONIC) 的结果，timestamp_ns 为 0 表示不可用
+    int64_t timestamp_position = 0;
+    int64_t timestamp_ns = 0;
+    float drift_correction_ppm = 0.0f;
+};
+
+// 批量提交的一段数据，位于 RegisterSubmitBuffers 注册的数据缓冲区内。
+// input_id 为 -1 时写入主输入，否则写入 OpenInput 返回的输入（此时 sample_format 被忽略）。
+struct SubmitDescriptor {
+    int32_t offset;
+    int32_t frames;
+    int32_t sample_format;
+    int32_t input_id;
+};
+
+struct WriteRegion {
+    void* data = nullptr;
+    int32_t frames = 0;
+};
+
 class OboeAudioRenderer {
 public:
     OboeAudioRenderer();
@@ -49,13 +101,70 @@ public:
     bool WriteAudio(const int16_t* data, int32_t num_frames);
     bool WriteAudioRaw(const void* data, int32_t num_frames, int32_t sampleFormat);
     
+    // 零拷贝写入：直接返回环形缓冲区内的连续区域，格式与 InitializeWithFormat 一致。
+    // 区域不会跨越环绕点，不足 max_frames 时可以再次调用。仅环形缓冲区模式可用。
+    WriteRegion BeginWrite(int32_t max_frames);
+    bool CommitWrite(int32_t num_frames);
+    
+    // 额外输入与主输入在同一个流中混音，采样率必须与 Initialize 时一致。
+    // 每个输入只能有一个生产者线程，缓冲区满时丢弃数据，不受背压策略影响。
+    int32_t OpenInput(int32_t channelCount, int32_t sampleFormat);
+    void CloseInput(int32_t input_id) { m_mixer.CloseInput(input_id); }
+    bool WriteInput(int32_t input_id, const void* data, int32_t num_frames) { return m_mixer.Write(input_id, data, num_frames); }
+    void SetInputVolume(int32_t input_id, float volume) { m_mixer.SetInputVolume(input_id, volume); }
+    int32_t GetInputBufferedFrames(int32_t input_id) const { return m_mixer.GetBufferedFrames(input_id); }
+    
+    // 注册长期有效的数据缓冲区和描述符缓冲区（例如 direct ByteBuffer），之后每批提交只需要传描述符个数。
+    // 缓冲区由调用方持有，必须在 UnregisterSubmitBuffers 之后才能释放。
+    bool RegisterSubmitBuffers(void* data, size_t data_size, void* descriptors, size_t descriptors_size);
+    void UnregisterSubmitBuffers();
+    // 返回成功提交的描述符个数，遇到无效描述符或写入失败时停止
+    int32_t SubmitRegistered(int32_t count);
+    int32_t SubmitBatch(const SubmitDescriptor* descriptors, int32_t count);
+    
     bool IsInitialized() const { return m_initialized.load(); }
-    bool IsPlaying() const { return m_stream && m_stream->getState() == oboe::StreamState::Started; }
+    // m_stream 可能正在被恢复线程替换，需要加锁读取
+    bool IsPlaying() const;
     int32_t GetBufferedFrames() const;
     
     void SetVolume(float volume);
     float GetVolume() const { return m_volume.load(); }
 
+    // 下一次 Initialize 时生效
+    void SetBufferMode(int32_t mode) { m_buffer_mode.store(mode); }
+    int32_t GetBufferMode() const { return m_buffer_mode.load(); }
+    
+    // 0 表示由系统按 burst 大小决定，下一次打开流时生效
+    void SetFramesPerCallback(int32_t frames) { m_frames_per_callback.store(std::max(0, frames)); }
+    
+    // 自适应延迟控制器的当前目标缓冲区大小和累计 xrun 次数
+    int32_t GetLatencyTargetFrames() const { return m_latency_target_frames.load(); }
+    int32_t GetXRunCount() const { return m_xrun_count.load(); }
+    
+    // 当前打开的流实际使用的路径和参数
+    int32_t GetStreamTier() const { return m_stream_tier.load(); }
+    bool IsMMapUsed() const { return m_mmap_used.load(); }
+    int32_t GetFramesPerBurst() const { return m_frames_per_burst.load(); }
+    int32_t GetDeviceSampleRate() const { return m_device_sample_rate.load(); }
+    // 回调线程的 tid，用于设置亲和性和性能提示，回调还没运行时返回 0
+    int32_t GetCallbackThreadId() const { return m_callback_thread_id.load(); }
+    
+    // 缓冲区满时的处理方式：直接丢弃剩余数据，或最多等待 timeout_ms
+    void SetBackpressurePolicy(int32_t policy, int32_t timeout_ms);
+    
+    // 按缓冲区填充量微调消耗速度，补偿时钟漂移。仅环形缓冲区模式可用，默认开启：
+    // 回调里持续测量漂移，测到持续的漂移后才切换到重采样路径，关闭时不再测量
+    void SetDriftCompensation(bool enabled) { m_drift_compensation.store(enabled); }
+    bool IsDriftCompensationEnabled() const { return m_drift_compensation.load(); }
+    float GetDriftCorrectionPpm() const { return m_drift_correction_ppm.load(); }
+    int32_t GetRestartCount() const { return m_restart_count.load(); }
+    
+    void GetStats(AudioStats& stats) const;
+    
+    // 下一帧写入的数据预计被播放的时间（CLOCK_MONOTONIC 纳秒），未初始化时返回 0。
+    // 有硬件时间戳时用时间戳加上缓冲区里的帧数推算，否则用缓冲区大小估算。
+    int64_t GetNextWritePresentationTimeNs() const;
+
     void Reset();
 
 private:
@@ -86,38 +195,168 @@ private:
     void OnStreamErrorBeforeClose(oboe::AudioStream* audioStream, oboe::Result error);
 
     oboe::AudioFormat MapSampleFormat(int32_t format);
+    static int32_t MapOboeFormat(oboe::AudioFormat format);
     static size_t GetBytesPerSample(int32_t format);
     bool OptimizeBufferSize();
     
     bool TryRestartStream();
+    void RequestRestart();
+    void RecoveryThreadMain();
+    bool WaitForSpace(std::chrono::steady_clock::time_point& deadline);
+    // 会先关闭流，必须持有 m_stream_mutex
     void ClearAllBuffers();
+    bool ConfigureBuffers();
+    bool WriteToBlockQueue(const void* data, int32_t num_frames, int32_t sampleFormat);
+    int32_t ReadFromBlockQueue(void* audioData, int32_t num_frames);
+    size_t AcquireBlockRead(const uint8_t** region, size_t max_bytes, int32_t sample_format);
+    int32_t ReadFromRing(void* audioData, int32_t num_frames);
+    int32_t ReadConverted(void* audioData, int32_t num_frames, float gain, float gain_step);
+    int32_t ReadResampled(void* audioData, int32_t num_frames, float gain, float gain_step, int32_t& frames_consumed);
+    
+    // 非重采样路径的读取函数，在打开流时按（队列格式, 声道数, 设备格式, 缓冲模式）选定，
+    // 常见组合使用编译期展开的版本，其它组合退回通用路径
+    using ReadKernel = int32_t (OboeAudioRenderer::*)(void* audioData, int32_t num_frames, float gain, float gain_step);
+    void SelectReadKernel();
+    template <typename DstT>
+    ReadKernel SelectReadKernelFor(int32_t sample_format, int32_t channels, bool ring);
+    template <typename SrcT, int32_t SrcChannels, typename DstT, bool Ring>
+    int32_t ReadKernelSpecialized(void* audioData, int32_t num_frames, float gain, float gain_step);
+    int32_t ReadKernelGeneric(void* audioData, int32_t num_frames, float gain, float gain_step);
+    
+    void UpdateGainRamp(int32_t num_frames, float& gain, float& gain_step);
+    void UpdateCallbackStats(oboe::AudioStream* audioStream, int32_t num_frames, int32_t frames_read,
+                             int32_t frames_consumed, int64_t duration_ns);
+    void PublishTimestamp(oboe::AudioStream* audioStream);
+    // 流重建前调用，此时回调线程未运行
+    void ResetTimestamp();
+    bool ReadTimestamp(int64_t& position, int64_t& time_ns) const;
+    void ResetStats();
+    bool WriteConverted(const void* data, int32_t num_frames, int32_t sampleFormat);
+    void UpdateLatency(oboe::AudioStream* audioStream, int32_t num_frames, bool starved);
 
     std::shared_ptr<oboe::AudioStream> m_stream;
     std::unique_ptr<SimpleAudioCallback> m_audio_callback;
     std::unique_ptr<SimpleErrorCallback> m_error_callback;
     
-    std::mutex m_stream_mutex;
+    mutable std::mutex m_stream_mutex;
     std::atomic<bool> m_initialized{false};
     std::atomic<bool> m_stream_started{false};
     std::atomic<bool> m_needs_restart{false};
+    std::atomic<int32_t> m_restart_count{0};
+    
+    // 流恢复在独立线程中进行，不阻塞生产者
+    std::thread m_recovery_thread;
+    std::mutex m_recovery_mutex;
+    std::condition_variable m_recovery_cv;
+    bool m_recovery_exit = false;
+    
+    // 统计：m_frames_written 由生产者更新，其余由回调线程更新
+    std::atomic<int64_t> m_frames_written{0};
+    std::atomic<int64_t> m_frames_played{0};
+    std::atomic<int64_t> m_frames_discarded{0};
+    // 回调交给流的总帧数，包括欠载时填充的静音，与时间戳的位置对应
+    std::atomic<int64_t> m_frames_rendered{0};
+    std::atomic<int32_t> m_underrun_count{0};
+    std::atomic<int32_t> m_overrun_count{0};
+    std::atomic<int64_t> m_callback_count{0};
+    std::atomic<int64_t> m_callback_total_ns{0};
+    std::atomic<int64_t> m_callback_min_ns{0};
+    std::atomic<int64_t> m_callback_max_ns{0};
+    bool m_was_starved = false;
+    int32_t m_frames_since_timestamp = 0;
+    
+    // 时间戳用顺序锁发布，保证位置和时间是同一次查询的结果
+    std::atomic<uint32_t> m_timestamp_sequence{0};
+    std::atomic<int64_t> m_timestamp_position{0};
+    std::atomic<int64_t> m_timestamp_ns{0};
+    
+    std::atomic<int32_t> m_backpressure_policy{BACKPRESSURE_DROP};
+    std::atomic<int32_t> m_backpressure_timeout_ms{BACKPRESSURE_DEFAULT_TIMEOUT_MS};
     
     std::atomic<int32_t> m_sample_rate{48000};
     std::atomic<int32_t> m_channel_count{2};
     std::atomic<int32_t> m_sample_format{PCM_INT16};
     std::atomic<float> m_volume{1.0f};
+    std::atomic<int32_t> m_buffer_mode{BUFFER_MODE_RING};
+    int32_t m_active_buffer_mode = BUFFER_MODE_RING;
+    std::atomic<int32_t> m_frames_per_callback{oboe::kUnspecified};
+    
+    std::atomic<int32_t> m_stream_tier{STREAM_TIER_NONE};
+    std::atomic<bool> m_mmap_used{false};
+    std::atomic<int32_t> m_frames_per_burst{0};
+    std::atomic<int32_t> m_device_sample_rate{0};
+    std::atomic<int32_t> m_callback_thread_id{0};
     
     int32_t m_device_channels = 2;
+    int32_t m_device_format = PCM_FLOAT;
     oboe::AudioFormat m_oboe_format{oboe::AudioFormat::I16};
     
+    // 回调线程使用：环形缓冲区/队列格式 -> 设备格式
+    AudioFormatConverter m_output_converter;
+    ReadKernel m_read_kernel = &OboeAudioRenderer::ReadKernelGeneric;
+    alignas(16) uint8_t m_conversion_scratch[AudioFormatConverter::CHUNK_FRAMES * AudioFormatConverter::MAX_CHANNELS * sizeof(float)];
+    
+    // 音量渐变状态，只在回调线程中修改
+    float m_current_gain = 1.0f;
+    float m_gain_ramp_frames = 480.0f;
+    
+    // 漂移补偿，只在回调线程中使用：环形缓冲区格式 -> float -> 重采样 -> 设备格式
+    std::atomic<bool> m_drift_compensation{true};
+    std::atomic<float> m_drift_correction_ppm{0.0f};
+    bool m_resampler_active = false;
+    bool m_drift_measuring = false;
+    double m_drift_ratio = 1.0;
+    AudioDriftDetector m_drift_detector;
+    AudioDriftController m_drift_controller;
+    AudioResampler m_resampler;
+    AudioFormatConverter m_resampler_input_converter;
+    AudioFormatConverter m_resampler_output_converter;
+    alignas(16) float m_resampler_output[AudioResampler::MAX_OUTPUT_FRAMES * AudioResampler::MAX_CHANNELS];
+    
+    AudioMixer m_mixer;
+    
+    // 批量提交使用的缓冲区，只在生产者线程中使用
+    const uint8_t* m_submit_data = nullptr;
+    size_t m_submit_data_size = 0;
+    const SubmitDescriptor* m_submit_descriptors = nullptr;
+    int32_t m_submit_descriptor_capacity = 0;
+    
+    // 生产者线程使用：提交格式与初始化格式不一致时转换
+    AudioFormatConverter m_input_converter;
+    std::vector<uint8_t> m_input_scratch;
+    
     static constexpr uint32_t AUDIO_QUEUE_SIZE = 256;
+    // 队列 + 回调当前块 + 生产者正在填充的块
+    static constexpr uint32_t BLOCK_POOL_SIZE = AUDIO_QUEUE_SIZE + 2;
+    static constexpr uint32_t FREE_QUEUE_SIZE = 512;
+    static_assert(FREE_QUEUE_SIZE >= BLOCK_POOL_SIZE, "free queue must be able to hold every pooled block");
+    static constexpr int32_t RING_BUFFER_MS = 100;
+    static constexpr int32_t LATENCY_CHECKS_PER_SECOND = 20;
+    static constexpr int32_t GAIN_RAMP_MS = 10;
+    static constexpr int32_t TIMESTAMP_UPDATES_PER_SECOND = 20;
+    static constexpr int32_t BACKPRESSURE_DEFAULT_TIMEOUT_MS = 20;
+    static constexpr int32_t RECOVERY_INITIAL_DELAY_MS = 50;
+    static constexpr int32_t RECOVERY_MAX_DELAY_MS = 1000;
     
     LockFreeQueue<std::unique_ptr<AudioBlock>, AUDIO_QUEUE_SIZE> m_audio_queue;
     
     std::unique_ptr<AudioBlock> m_current_block;
+    // 生产者独占：入队失败的块
+    std::unique_ptr<AudioBlock> m_spare_block;
+
+    AudioRingBuffer m_ring_buffer;
+    
+    // 以下延迟控制状态只在回调线程中修改
+    AudioLatencyController m_latency_controller;
+    int32_t m_frames_since_latency_check = 0;
+    bool m_starved_since_latency_check = false;
+    std::atomic<int32_t> m_latency_target_frames{0};
+    std::atomic<int32_t> m_xrun_count{0};
+    int32_t m_pending_write_frames = 0;
     
-    // 简单对象池
-    std::vector<std::unique_ptr<AudioBlock>> m_block_pool;
-    std::mutex m_pool_mutex;
+    // 无锁对象池：回调线程归还，生产者线程取用
+    LockFreeQueue<std::unique_ptr<AudioBlock>, FREE_QUEUE_SIZE> m_free_blocks;
+    bool m_pool_initialized = false;
     
     std::unique_ptr<AudioBlock> AcquireBlock();
     void ReleaseBlock(std::unique_ptr<AudioBlock> block);
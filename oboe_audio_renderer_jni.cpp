@@ -0,0 +1,36 @@
+#include "oboe_audio_renderer.h"
+
+using RyujinxOboe::OboeAudioRenderer;
+
+// 批量提交入口，由托管代码通过 P/Invoke 调用。数据和描述符都放在注册一次的固定缓冲区里，
+// 每批提交只跨越一次边界，也不复制任何数组。
+extern "C" {
+
+// P/Invoke：data 和 descriptors 由调用方固定，直到 oboeUnregisterSubmitBuffers
+bool oboeRegisterSubmitBuffers(void* renderer, void* data, size_t data_size, void* descriptors, size_t descriptors_size) {
+    if (!renderer) return false;
+    return static_cast<OboeAudioRenderer*>(renderer)->RegisterSubmitBuffers(data, data_size, descriptors, descriptors_size);
+}
+
+void oboeUnregisterSubmitBuffers(void* renderer) {
+    if (!renderer) return;
+    static_cast<OboeAudioRenderer*>(renderer)->UnregisterSubmitBuffers();
+}
+
+int32_t oboeSubmitBatch(void* renderer, int32_t count) {
+    if (!renderer) return 0;
+    return static_cast<OboeAudioRenderer*>(renderer)->SubmitRegistered(count);
+}
+
+// P/Invoke：漂移补偿默认开启，测到持续漂移后才会重采样
+void oboeSetDriftCompensation(void* renderer, bool enabled) {
+    if (!renderer) return;
+    static_cast<OboeAudioRenderer*>(renderer)->SetDriftCompensation(enabled);
+}
+
+bool oboeIsDriftCompensationEnabled(void* renderer) {
+    if (!renderer) return false;
+    return static_cast<OboeAudioRenderer*>(renderer)->IsDriftCompensationEnabled();
+}
+
+} // extern "C"
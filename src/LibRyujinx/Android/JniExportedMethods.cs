@@ -35,6 +35,32 @@ namespace LibRyujinx
         [DllImport("libryujinxjni")]
         internal extern static void setCurrentTransform(long native_window, int transform);
 
+        [DllImport("libryujinxjni")]
+        internal extern static void onFramePresented(long native_window);
+
+        [DllImport("libryujinxjni")]
+        internal extern static void onFrameDropped(long native_window);
+
+        [DllImport("libryujinxjni")]
+        internal extern static int getSwapchainBufferCount();
+
+        [DllImport("libryujinxjni")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        internal extern static bool getPrerotation();
+
+        [DllImport("libryujinxjni")]
+        internal extern static long getDequeueTimeout();
+
+        [DllImport("libryujinxjni")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        internal extern static bool getSharedPresentRequested();
+
+        [DllImport("libryujinxjni")]
+        internal extern static void setSharedPresentActive([MarshalAs(UnmanagedType.I1)] bool active);
+
+        [DllImport("libryujinxjni")]
+        internal extern static void reportRenderFrameDuration(long durationNs);
+
         public delegate IntPtr JniCreateSurface(IntPtr native_surface, IntPtr instance);
 
         [UnmanagedCallersOnly(EntryPoint = "javaInitialize")]
@@ -274,7 +300,12 @@ namespace LibRyujinx
 
             if (driverHandle != 0)
             {
-                VulkanLoader = new VulkanLoader((IntPtr)driverHandle);
+                VulkanLoader = new VulkanLoader((IntPtr)driverHandle, ownsLibrary: false);
+            }
+            else
+            {
+                // The system driver also goes through the loader so device calls get the direct dispatch table
+                VulkanLoader = new VulkanLoader(NativeLibrary.Load("libvulkan.so"));
             }
 
             CreateSurface createSurfaceFunc = instance =>
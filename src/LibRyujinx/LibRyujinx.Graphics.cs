@@ -13,6 +13,7 @@ using Ryujinx.Graphics.Vulkan;
 using Silk.NET.Vulkan;
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Runtime.InteropServices;
 using System.Threading;
 
@@ -64,9 +65,16 @@ namespace LibRyujinx
             }
             else if (graphicsBackend == GraphicsBackend.Vulkan)
             {
-                Renderer = new VulkanRenderer(Vk.GetApi(), (instance, vk) => new SurfaceKHR(createSurfaceFunc == null ? null : (ulong?)createSurfaceFunc(instance.Handle)),
+                var vulkanRenderer = new VulkanRenderer(VulkanLoader?.GetApi() ?? Vk.GetApi(), (instance, vk) => new SurfaceKHR(createSurfaceFunc == null ? null : (ulong?)createSurfaceFunc(instance.Handle)),
                     () => requiredExtensions,
                     null);
+
+                if (Ryujinx.Common.PlatformInfo.IsBionic)
+                {
+                    vulkanRenderer.PipelineCacheStore = new NativePipelineCacheStore();
+                }
+
+                Renderer = vulkanRenderer;
             }
             else
             {
@@ -119,6 +127,8 @@ namespace LibRyujinx
                         setRenderingThread();
                     }
 
+                    long frameStart = 0;
+
                     while (_isActive)
                     {
                         if (_isStopped)
@@ -128,6 +138,11 @@ namespace LibRyujinx
 
                         if (device.WaitFifo())
                         {
+                            if (frameStart == 0)
+                            {
+                                frameStart = Stopwatch.GetTimestamp();
+                            }
+
                             device.Statistics.RecordFifoStart();
                             device.ProcessFrame();
                             device.Statistics.RecordFifoEnd();
@@ -137,12 +152,48 @@ namespace LibRyujinx
                         {
                             device.PresentFrame(() =>
                             {
+                                bool frameDropped = false;
+
                                 if (device.Gpu.Renderer is ThreadedRenderer threaded && threaded.BaseRenderer is VulkanRenderer vulkanRenderer)
                                 {
-                                    setCurrentTransform(_window, (int)vulkanRenderer.CurrentTransform);
+                                    frameDropped = vulkanRenderer.IsFrameDropped;
+
+                                    // A pre-rotated swapchain already tells the compositor its transform
+                                    if (!vulkanRenderer.IsPrerotated)
+                                    {
+                                        setCurrentTransform(_window, (int)vulkanRenderer.CurrentTransform);
+                                    }
+
+                                    vulkanRenderer.SetPrerotation(getPrerotation());
+                                    vulkanRenderer.SetSharedPresent(getSharedPresentRequested());
+                                    setSharedPresentActive(vulkanRenderer.IsSharedPresent);
+
+                                    long dequeueTimeout = getDequeueTimeout();
+                                    vulkanRenderer.SetPresentQueueConfig((uint)getSwapchainBufferCount(), dequeueTimeout < 0 ? ulong.MaxValue : (ulong)dequeueTimeout);
+                                }
+
+                                if (Ryujinx.Common.PlatformInfo.IsBionic)
+                                {
+                                    // A dropped frame queued nothing, so there are no present stats to sample or timestamps to pace
+                                    if (frameDropped)
+                                    {
+                                        onFrameDropped(_window);
+                                    }
+                                    else
+                                    {
+                                        onFramePresented(_window);
+                                    }
                                 }
                                 _swapBuffersCallback?.Invoke();
                             });
+
+                            // Wall time from the first FIFO batch of the frame to its present, including any waits in between;
+                            // the native side takes the CPU share from the thread CPU time
+                            if (Ryujinx.Common.PlatformInfo.IsBionic && frameStart != 0)
+                            {
+                                reportRenderFrameDuration((long)Stopwatch.GetElapsedTime(frameStart).TotalNanoseconds);
+                                frameStart = 0;
+                            }
                         }
                     }
 
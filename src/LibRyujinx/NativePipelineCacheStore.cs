@@ -0,0 +1,41 @@
+using Ryujinx.Graphics.Vulkan;
+using Silk.NET.Vulkan;
+using System;
+using System.Runtime.InteropServices;
+
+namespace LibRyujinx
+{
+    /// <summary>
+    /// Pipeline cache store backed by the native pipeline cache module, which keeps one cache file per driver.
+    /// </summary>
+    public class NativePipelineCacheStore : IPipelineCacheStore
+    {
+        [DllImport("libryujinxjni")]
+        [return: MarshalAs(UnmanagedType.I1)]
+        private extern static unsafe bool loadPipelineCache(byte* uuid, out IntPtr data, out nuint size);
+
+        [DllImport("libryujinxjni")]
+        private extern static void attachPipelineCache(IntPtr device, ulong cache);
+
+        [DllImport("libryujinxjni")]
+        private extern static void detachPipelineCache();
+
+        public unsafe bool TryLoad(ReadOnlySpan<byte> uuid, out IntPtr data, out nuint size)
+        {
+            fixed (byte* uuidPtr = uuid)
+            {
+                return loadPipelineCache(uuidPtr, out data, out size);
+            }
+        }
+
+        public void Attach(Device device, PipelineCache cache)
+        {
+            attachPipelineCache(device.Handle, cache.Handle);
+        }
+
+        public void Detach()
+        {
+            detachPipelineCache();
+        }
+    }
+}
@@ -17,22 +17,45 @@ namespace LibRyujinx
         private delegate IntPtr GetInstanceProcAddress(IntPtr instance, IntPtr name);
         private delegate IntPtr GetDeviceProcAddress(IntPtr device, IntPtr name);
 
+        [DllImport("libryujinxjni")]
+        private extern static void setVulkanDriver(IntPtr driverHandle);
+
+        [DllImport("libryujinxjni")]
+        private extern static IntPtr getVulkanDeviceFunction(IntPtr device, IntPtr name);
+
+        [DllImport("libryujinxjni")]
+        private extern static void releaseVulkanDevice(IntPtr device);
+
         private IntPtr _loadedLibrary = IntPtr.Zero;
+        private readonly bool _ownsLibrary;
         private GetInstanceProcAddress _getInstanceProcAddr;
         private GetDeviceProcAddress _getDeviceProcAddr;
+        private IntPtr _device = IntPtr.Zero;
 
         public void Dispose()
         {
+            if (_device != IntPtr.Zero)
+            {
+                releaseVulkanDevice(_device);
+                _device = IntPtr.Zero;
+            }
+
             if (_loadedLibrary != IntPtr.Zero)
             {
-                NativeLibrary.Free(_loadedLibrary);
+                // Custom drivers stay loaded in the native driver registry so relaunches can reuse them
+                if (_ownsLibrary)
+                {
+                    NativeLibrary.Free(_loadedLibrary);
+                }
+
                 _loadedLibrary = IntPtr.Zero;
             }
         }
 
-        public VulkanLoader(IntPtr driver)
+        public VulkanLoader(IntPtr driver, bool ownsLibrary = true)
         {
             _loadedLibrary = driver;
+            _ownsLibrary = ownsLibrary;
 
             if (_loadedLibrary != IntPtr.Zero)
             {
@@ -41,6 +64,8 @@ namespace LibRyujinx
 
                 _getInstanceProcAddr = Marshal.GetDelegateForFunctionPointer<GetInstanceProcAddress>(instanceGetProc);
                 _getDeviceProcAddr = Marshal.GetDelegateForFunctionPointer<GetDeviceProcAddress>(deviceProc);
+
+                setVulkanDriver(_loadedLibrary);
             }
         }
 
@@ -62,7 +87,19 @@ namespace LibRyujinx
                     try
                     {
                         nint ptr = default;
-                        ptr = _getInstanceProcAddr(ret.CurrentInstance.GetValueOrDefault().Handle, xPtr);
+
+                        // Device level functions come from the native per device table, which skips the loader dispatch
+                        var device = ret.CurrentDevice.GetValueOrDefault().Handle;
+                        if (device != IntPtr.Zero)
+                        {
+                            _device = device;
+                            ptr = getVulkanDeviceFunction(device, xPtr);
+                        }
+
+                        if (ptr == default)
+                        {
+                            ptr = _getInstanceProcAddr(ret.CurrentInstance.GetValueOrDefault().Handle, xPtr);
+                        }
 
                         if (ptr == default)
                         {
@@ -35,6 +35,7 @@ namespace Ryujinx.Graphics.Vulkan
         private readonly IProgram _programColorBlit;
         private readonly IProgram _programColorBlitMs;
         private readonly IProgram _programColorBlitClearAlpha;
+        private readonly IProgram _programColorBlitClearAlphaTranspose;
         private readonly IProgram _programColorClearF;
         private readonly IProgram _programColorClearSI;
         private readonly IProgram _programColorClearUI;
@@ -86,6 +87,12 @@ namespace Ryujinx.Graphics.Vulkan
                 new ShaderSource(ReadSpirv("ColorBlitClearAlphaFragment.spv"), ShaderStage.Fragment, TargetLanguage.Spirv),
             }, blitResourceLayout);
 
+            _programColorBlitClearAlphaTranspose = gd.CreateProgramWithMinimalLayout(new[]
+            {
+                new ShaderSource(ReadSpirv("ColorBlitTransposeVertex.spv"), ShaderStage.Vertex, TargetLanguage.Spirv),
+                new ShaderSource(ReadSpirv("ColorBlitClearAlphaFragment.spv"), ShaderStage.Fragment, TargetLanguage.Spirv),
+            }, blitResourceLayout);
+
             var colorClearResourceLayout = new ResourceLayoutBuilder().Add(ResourceStages.Vertex, ResourceType.UniformBuffer, 1).Build();
 
             _programColorClearF = gd.CreateProgramWithMinimalLayout(new[]
@@ -375,7 +382,8 @@ namespace Ryujinx.Graphics.Vulkan
             Extents2D srcRegion,
             Extents2D dstRegion,
             bool linearFilter,
-            bool clearAlpha = false)
+            bool clearAlpha = false,
+            bool transpose = false)
         {
             _pipeline.SetCommandBuffer(cbs);
 
@@ -392,12 +400,14 @@ namespace Ryujinx.Graphics.Vulkan
             region[2] = (float)srcRegion.Y1 / src.Height;
             region[3] = (float)srcRegion.Y2 / src.Height;
 
-            if (dstRegion.X1 > dstRegion.X2)
+            // When transposing, the source X axis runs along the destination Y axis and vice versa.
+            // This is only used to present to pre-rotated swapchains, so only the clear alpha variant supports it.
+            if (transpose ? dstRegion.Y1 > dstRegion.Y2 : dstRegion.X1 > dstRegion.X2)
             {
                 (region[0], region[1]) = (region[1], region[0]);
             }
 
-            if (dstRegion.Y1 > dstRegion.Y2)
+            if (transpose ? dstRegion.X1 > dstRegion.X2 : dstRegion.Y1 > dstRegion.Y2)
             {
                 (region[2], region[3]) = (region[3], region[2]);
             }
@@ -438,7 +448,7 @@ namespace Ryujinx.Graphics.Vulkan
             }
             else if (clearAlpha)
             {
-                _pipeline.SetProgram(_programColorBlitClearAlpha);
+                _pipeline.SetProgram(transpose ? _programColorBlitClearAlphaTranspose : _programColorBlitClearAlpha);
             }
             else
             {
@@ -1705,6 +1715,7 @@ namespace Ryujinx.Graphics.Vulkan
             if (disposing)
             {
                 _programColorBlitClearAlpha.Dispose();
+                _programColorBlitClearAlphaTranspose.Dispose();
                 _programColorBlit.Dispose();
                 _programColorBlitMs.Dispose();
                 _programColorClearF.Dispose();
@@ -0,0 +1,28 @@
+using Silk.NET.Vulkan;
+using System;
+
+namespace Ryujinx.Graphics.Vulkan
+{
+    /// <summary>
+    /// Persists the driver pipeline cache between runs.
+    /// </summary>
+    public interface IPipelineCacheStore
+    {
+        /// <summary>
+        /// Gets the stored cache data for the device with the given pipeline cache UUID.
+        /// The data must stay valid until <see cref="Attach"/> is called.
+        /// </summary>
+        /// <returns>True if stored data was found, false otherwise</returns>
+        bool TryLoad(ReadOnlySpan<byte> uuid, out IntPtr data, out nuint size);
+
+        /// <summary>
+        /// Starts tracking the pipeline cache, writing it back as it grows.
+        /// </summary>
+        void Attach(Device device, PipelineCache cache);
+
+        /// <summary>
+        /// Writes the pipeline cache a final time and stops tracking it. Called before the cache is destroyed.
+        /// </summary>
+        void Detach();
+    }
+}
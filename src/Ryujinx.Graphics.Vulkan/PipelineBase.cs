@@ -94,7 +94,9 @@ namespace Ryujinx.Graphics.Vulkan
         public ulong DrawCount { get; private set; }
         public bool RenderPassActive { get; private set; }
 
-        public unsafe PipelineBase(VulkanRenderer gd, Device device)
+        private readonly IPipelineCacheStore _cacheStore;
+
+        public unsafe PipelineBase(VulkanRenderer gd, Device device, IPipelineCacheStore cacheStore = null)
         {
             Gd = gd;
             Device = device;
@@ -107,7 +109,28 @@ namespace Ryujinx.Graphics.Vulkan
                 SType = StructureType.PipelineCacheCreateInfo,
             };
 
-            gd.Api.CreatePipelineCache(device, in pipelineCacheCreateInfo, null, out PipelineCache).ThrowOnError();
+            var properties = gd.PhysicalDeviceProperties;
+
+            if (cacheStore != null && cacheStore.TryLoad(new ReadOnlySpan<byte>(properties.PipelineCacheUuid, 16), out IntPtr initialData, out nuint initialDataSize))
+            {
+                pipelineCacheCreateInfo.InitialDataSize = initialDataSize;
+                pipelineCacheCreateInfo.PInitialData = (void*)initialData;
+            }
+
+            if (gd.Api.CreatePipelineCache(device, in pipelineCacheCreateInfo, null, out PipelineCache) != Result.Success)
+            {
+                // The stored data may be corrupted, or rejected by the driver. Start from an empty cache.
+                pipelineCacheCreateInfo.InitialDataSize = 0;
+                pipelineCacheCreateInfo.PInitialData = null;
+
+                gd.Api.CreatePipelineCache(device, in pipelineCacheCreateInfo, null, out PipelineCache).ThrowOnError();
+            }
+
+            if (cacheStore != null)
+            {
+                _cacheStore = cacheStore;
+                _cacheStore.Attach(device, PipelineCache);
+            }
 
             _descriptorSetUpdater = new DescriptorSetUpdater(gd, device);
             _vertexBufferUpdater = new VertexBufferUpdater(gd);
@@ -1795,6 +1818,8 @@ namespace Ryujinx.Graphics.Vulkan
 
                 Pipeline?.Dispose();
 
+                _cacheStore?.Detach();
+
                 unsafe
                 {
                     Gd.Api.DestroyPipelineCache(Device, PipelineCache, null);
@@ -20,7 +20,7 @@ namespace Ryujinx.Graphics.Vulkan
 
         private readonly List<BufferHolder> _backingSwaps;
 
-        public PipelineFull(VulkanRenderer gd, Device device) : base(gd, device)
+        public PipelineFull(VulkanRenderer gd, Device device, IPipelineCacheStore cacheStore) : base(gd, device, cacheStore)
         {
             _activeQueries = new List<(QueryPool, bool)>();
             _pendingQueryCopies = new();
@@ -46,6 +46,8 @@ namespace Ryujinx.Graphics.Vulkan
             "VK_KHR_maintenance2",
             "VK_EXT_attachment_feedback_loop_layout",
             "VK_EXT_attachment_feedback_loop_dynamic_state",
+            "VK_KHR_shared_presentable_image",
+            "VK_KHR_incremental_present",
         };
 
         private static readonly string[] _requiredExtensions = {
@@ -83,6 +85,12 @@ namespace Ryujinx.Graphics.Vulkan
                 enabledExtensions = enabledExtensions.Append(ExtDebugUtils.ExtensionName).ToArray();
             }
 
+            // Required by VK_KHR_shared_presentable_image.
+            if (instanceExtensions.Contains("VK_KHR_get_surface_capabilities2"))
+            {
+                enabledExtensions = enabledExtensions.Append("VK_KHR_get_surface_capabilities2").ToArray();
+            }
+
             var appName = Marshal.StringToHGlobalAnsi(AppName);
 
             var applicationInfo = new ApplicationInfo
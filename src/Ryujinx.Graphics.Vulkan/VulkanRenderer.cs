@@ -33,6 +33,8 @@ namespace Ryujinx.Graphics.Vulkan
         internal Vk Api { get; private set; }
         internal KhrSurface SurfaceApi { get; private set; }
         internal KhrSwapchain SwapchainApi { get; private set; }
+        internal bool SupportsSharedPresentableImage { get; private set; }
+        internal bool SupportsIncrementalPresent { get; private set; }
         internal ExtConditionalRendering ConditionalRenderingApi { get; private set; }
         internal ExtExtendedDynamicState ExtendedDynamicStateApi { get; private set; }
         internal KhrPushDescriptor PushDescriptorApi { get; private set; }
@@ -75,6 +77,42 @@ namespace Ryujinx.Graphics.Vulkan
         public IWindow Window => _window;
 
         public SurfaceTransformFlagsKHR CurrentTransform => _window.CurrentTransform;
+        public bool IsPrerotated => _window.IsPrerotated;
+
+        /// <summary>
+        /// Overrides the swapchain image count (0 keeps the default) and the timeout used when acquiring an image.
+        /// Frames are dropped instead of stalling when the acquire times out.
+        /// </summary>
+        public void SetPresentQueueConfig(uint imageCount, ulong acquireTimeout) => _window.SetPresentQueueConfig(imageCount, acquireTimeout);
+
+        /// <summary>
+        /// Renders presented frames in the display's native orientation, so the compositor doesn't need to rotate them.
+        /// </summary>
+        public void SetPrerotation(bool enabled) => _window.SetPrerotation(enabled);
+
+        /// <summary>
+        /// Presents from a single image the compositor keeps scanning out, instead of queueing images.
+        /// Takes effect on the next swapchain recreation, if the driver supports VK_KHR_shared_presentable_image.
+        /// </summary>
+        public void SetSharedPresent(bool enabled) => _window.SetSharedPresent(enabled);
+
+        /// <summary>
+        /// Whether the current swapchain uses a shared presentable image.
+        /// </summary>
+        public bool IsSharedPresent => _window.IsSharedPresent;
+
+        /// <summary>
+        /// Whether the last present dropped its frame on an acquire timeout.
+        /// </summary>
+        public bool IsFrameDropped => _window.IsFrameDropped;
+
+        /// <summary>
+        /// Store used to persist the pipeline cache, or null to keep it in memory only.
+        /// Must be set before the renderer is initialized.
+        /// </summary>
+        public IPipelineCacheStore PipelineCacheStore { get; set; }
+
+        internal PhysicalDeviceProperties PhysicalDeviceProperties => _physicalDevice.PhysicalDeviceProperties;
 
         private readonly Func<Instance, Vk, SurfaceKHR> _getSurface;
         private readonly Func<string[]> _getRequiredExtensions;
@@ -460,7 +498,7 @@ namespace Ryujinx.Graphics.Vulkan
             BufferManager = new BufferManager(this, _device);
 
             SyncManager = new SyncManager(this, _device);
-            _pipeline = new PipelineFull(this, _device);
+            _pipeline = new PipelineFull(this, _device, PipelineCacheStore);
             _pipeline.Initialize();
 
             HelperShader = new HelperShader(this, _device);
@@ -487,6 +525,9 @@ namespace Ryujinx.Graphics.Vulkan
 
             _device = VulkanInitialization.CreateDevice(Api, _physicalDevice, queueFamilyIndex, maxQueueCount);
 
+            SupportsSharedPresentableImage = _physicalDevice.IsDeviceExtensionPresent("VK_KHR_shared_presentable_image");
+            SupportsIncrementalPresent = _physicalDevice.IsDeviceExtensionPresent("VK_KHR_incremental_present");
+
             if (Api.TryGetDeviceExtension(_instance.Instance, _device, out KhrSwapchain swapchainApi))
             {
                 SwapchainApi = swapchainApi;
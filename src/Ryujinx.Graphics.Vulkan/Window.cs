@@ -41,6 +41,14 @@ namespace Ryujinx.Graphics.Vulkan
         private bool _updateScalingFilter;
         private ScalingFilter _currentScalingFilter;
         private bool _colorSpacePassthroughEnabled;
+        private uint _preferredImageCount;
+        private ulong _acquireTimeout = ulong.MaxValue;
+        private bool _prerotationEnabled;
+        private SurfaceTransformFlagsKHR _prerotation = SurfaceTransformFlagsKHR.IdentityBitKhr;
+        private bool _sharedPresentEnabled;
+        // Part of the swapchain image the last frame was drawn to, the rest is cleared.
+        private Extents2D _presentRegion;
+        private bool _presentRegionValid;
 
         public unsafe Window(VulkanRenderer gd, SurfaceKHR surface, PhysicalDevice physicalDevice, Device device)
         {
@@ -116,12 +124,23 @@ namespace Ryujinx.Graphics.Vulkan
                 _gd.SurfaceApi.GetPhysicalDeviceSurfacePresentModes(_physicalDevice, _surface, &presentModesCount, pPresentModes);
             }
 
-            uint imageCount = capabilities.MinImageCount + 1;
+            // A shared presentable image is a single image the compositor keeps scanning out,
+            // so it can't be combined with a queue of images.
+            bool sharedPresent = _sharedPresentEnabled &&
+                                 _gd.SupportsSharedPresentableImage &&
+                                 presentModes.Contains(PresentModeKHR.SharedContinuousRefreshKhr);
+
+            uint imageCount = _preferredImageCount != 0 ? Math.Max(_preferredImageCount, capabilities.MinImageCount) : capabilities.MinImageCount + 1;
             if (capabilities.MaxImageCount > 0 && imageCount > capabilities.MaxImageCount)
             {
                 imageCount = capabilities.MaxImageCount;
             }
 
+            if (sharedPresent)
+            {
+                imageCount = 1;
+            }
+
             var surfaceFormat = ChooseSwapSurfaceFormat(surfaceFormats, _colorSpacePassthroughEnabled);
 
             var extent = ChooseSwapExtent(capabilities);
@@ -134,6 +153,15 @@ namespace Ryujinx.Graphics.Vulkan
 
             CurrentTransform = capabilities.CurrentTransform;
 
+            _prerotation = ChoosePrerotation(capabilities);
+            IsPrerotated = _prerotation != SurfaceTransformFlagsKHR.IdentityBitKhr;
+
+            if (IsTransposed(_prerotation))
+            {
+                // Pre-rotated images are in the panel's native orientation.
+                extent = new Extent2D(extent.Height, extent.Width);
+            }
+
             var swapchainCreateInfo = new SwapchainCreateInfoKHR
             {
                 SType = StructureType.SwapchainCreateInfoKhr,
@@ -145,15 +173,17 @@ namespace Ryujinx.Graphics.Vulkan
                 ImageUsage = ImageUsageFlags.ColorAttachmentBit | ImageUsageFlags.TransferDstBit | (Ryujinx.Common.PlatformInfo.IsBionic ? 0 : ImageUsageFlags.StorageBit),
                 ImageSharingMode = SharingMode.Exclusive,
                 ImageArrayLayers = 1,
-                PreTransform = Ryujinx.Common.PlatformInfo.IsBionic ? SurfaceTransformFlagsKHR.IdentityBitKhr : capabilities.CurrentTransform,
+                PreTransform = Ryujinx.Common.PlatformInfo.IsBionic ? _prerotation : capabilities.CurrentTransform,
                 CompositeAlpha = ChooseCompositeAlpha(capabilities.SupportedCompositeAlpha),
-                PresentMode = ChooseSwapPresentMode(presentModes, _vsyncEnabled),
+                PresentMode = sharedPresent ? PresentModeKHR.SharedContinuousRefreshKhr : ChooseSwapPresentMode(presentModes, _vsyncEnabled),
                 Clipped = true,
             };
 
+            _presentRegionValid = false;
+
             var textureCreateInfo = new TextureCreateInfo(
-                _width,
-                _height,
+                (int)extent.Width,
+                (int)extent.Height,
                 1,
                 1,
                 1,
@@ -170,6 +200,8 @@ namespace Ryujinx.Graphics.Vulkan
 
             _gd.SwapchainApi.CreateSwapchain(_device, in swapchainCreateInfo, null, out _swapchain).ThrowOnError();
 
+            IsSharedPresent = sharedPresent;
+
             _gd.SwapchainApi.GetSwapchainImages(_device, _swapchain, &imageCount, null);
 
             _swapchainImages = new Image[imageCount];
@@ -303,6 +335,44 @@ namespace Ryujinx.Graphics.Vulkan
             }
         }
 
+        private SurfaceTransformFlagsKHR ChoosePrerotation(SurfaceCapabilitiesKHR capabilities)
+        {
+            // The scaling filters can't rotate, leave the rotation to the compositor when one is active.
+            bool canRotate = _currentScalingFilter == ScalingFilter.Bilinear || _currentScalingFilter == ScalingFilter.Nearest;
+
+            if (!_prerotationEnabled || !canRotate || !Ryujinx.Common.PlatformInfo.IsBionic)
+            {
+                return SurfaceTransformFlagsKHR.IdentityBitKhr;
+            }
+
+            var transform = capabilities.CurrentTransform;
+
+            bool isRotation = transform == SurfaceTransformFlagsKHR.Rotate90BitKhr ||
+                              transform == SurfaceTransformFlagsKHR.Rotate180BitKhr ||
+                              transform == SurfaceTransformFlagsKHR.Rotate270BitKhr;
+
+            return isRotation && capabilities.SupportedTransforms.HasFlag(transform) ? transform : SurfaceTransformFlagsKHR.IdentityBitKhr;
+        }
+
+        private static bool IsTransposed(SurfaceTransformFlagsKHR transform)
+        {
+            return transform == SurfaceTransformFlagsKHR.Rotate90BitKhr || transform == SurfaceTransformFlagsKHR.Rotate270BitKhr;
+        }
+
+        /// <summary>
+        /// Maps a point in presentation orientation to the pre-rotated swapchain image.
+        /// </summary>
+        private (int X, int Y) Prerotate(int x, int y)
+        {
+            return _prerotation switch
+            {
+                SurfaceTransformFlagsKHR.Rotate90BitKhr => (_height - y, x),
+                SurfaceTransformFlagsKHR.Rotate180BitKhr => (_width - x, _height - y),
+                SurfaceTransformFlagsKHR.Rotate270BitKhr => (y, _width - x),
+                _ => (x, y),
+            };
+        }
+
         public static Extent2D ChooseSwapExtent(SurfaceCapabilitiesKHR capabilities)
         {
             if (capabilities.CurrentExtent.Width != uint.MaxValue)
@@ -328,7 +398,7 @@ namespace Ryujinx.Graphics.Vulkan
                 var acquireResult = _gd.SwapchainApi.AcquireNextImage(
                     _device,
                     _swapchain,
-                    ulong.MaxValue,
+                    _acquireTimeout,
                     _imageAvailableSemaphores[semaphoreIndex],
                     new Fence(),
                     ref nextImage);
@@ -344,6 +414,14 @@ namespace Ryujinx.Graphics.Vulkan
                 {
                     _gd.RecreateSurface();
                 }
+                else if (acquireResult == Result.Timeout || acquireResult == Result.NotReady)
+                {
+                    // The compositor is late, drop this frame rather than stall the GPU thread.
+                    // The frame still ends here, the callback checks IsFrameDropped to skip present bookkeeping.
+                    IsFrameDropped = true;
+                    swapBuffersCallback?.Invoke();
+                    return;
+                }
                 else
                 {
                     acquireResult.ThrowOnError();
@@ -432,6 +510,15 @@ namespace Ryujinx.Graphics.Vulkan
             int dstY0 = crop.FlipY ? dstPaddingY : _height - dstPaddingY;
             int dstY1 = crop.FlipY ? _height - dstPaddingY : dstPaddingY;
 
+            var (dstImageX0, dstImageY0) = Prerotate(dstX0, dstY1);
+            var (dstImageX1, dstImageY1) = Prerotate(dstX1, dstY0);
+
+            var presentRegion = new Extents2D(
+                Math.Min(dstImageX0, dstImageX1),
+                Math.Min(dstImageY0, dstImageY1),
+                Math.Max(dstImageX0, dstImageX1),
+                Math.Max(dstImageY0, dstImageY1));
+
             if (_scalingFilter != null)
             {
                 _scalingFilter.Run(
@@ -453,9 +540,10 @@ namespace Ryujinx.Graphics.Vulkan
                     view,
                     _swapchainImageViews[nextImage],
                     new Extents2D(srcX0, srcY0, srcX1, srcY1),
-                    new Extents2D(dstX0, dstY1, dstX1, dstY0),
+                    new Extents2D(dstImageX0, dstImageY0, dstImageX1, dstImageY1),
                     _isLinear,
-                    true);
+                    true,
+                    IsTransposed(_prerotation));
             }
 
             Transition(
@@ -464,7 +552,7 @@ namespace Ryujinx.Graphics.Vulkan
                 0,
                 0,
                 ImageLayout.General,
-                ImageLayout.PresentSrcKhr);
+                IsSharedPresent ? ImageLayout.SharedPresentKhr : ImageLayout.PresentSrcKhr);
 
             _gd.CommandBufferPool.Return(
                 cbs,
@@ -489,11 +577,50 @@ namespace Ryujinx.Graphics.Vulkan
                 PResults = &result,
             };
 
+            // The area around the frame only changes with the frame rect, so once a rect has been
+            // presented on this swapchain only the rect is reported as changed. Without regions the
+            // whole image is treated as changed.
+            bool presentRegionChanged = !_presentRegionValid ||
+                                        presentRegion.X1 != _presentRegion.X1 ||
+                                        presentRegion.Y1 != _presentRegion.Y1 ||
+                                        presentRegion.X2 != _presentRegion.X2 ||
+                                        presentRegion.Y2 != _presentRegion.Y2;
+
+            _presentRegion = presentRegion;
+            _presentRegionValid = presentRegion.X2 > presentRegion.X1 && presentRegion.Y2 > presentRegion.Y1;
+
+            var rectangle = new RectLayerKHR
+            {
+                Offset = new Offset2D(presentRegion.X1, presentRegion.Y1),
+                Extent = new Extent2D((uint)(presentRegion.X2 - presentRegion.X1), (uint)(presentRegion.Y2 - presentRegion.Y1)),
+                Layer = 0,
+            };
+
+            var region = new PresentRegionKHR
+            {
+                RectangleCount = 1,
+                PRectangles = &rectangle,
+            };
+
+            var presentRegions = new PresentRegionsKHR
+            {
+                SType = StructureType.PresentRegionsKhr,
+                SwapchainCount = 1,
+                PRegions = &region,
+            };
+
+            if (_gd.SupportsIncrementalPresent && _presentRegionValid && !presentRegionChanged)
+            {
+                presentInfo.PNext = &presentRegions;
+            }
+
             lock (_gd.QueueLock)
             {
                 _gd.SwapchainApi.QueuePresent(_gd.Queue, in presentInfo);
             }
 
+            IsFrameDropped = false;
+
             //While this does nothing in most cases, it's useful to notify the end of the frame.
             swapBuffersCallback?.Invoke();
         }
@@ -517,6 +644,12 @@ namespace Ryujinx.Graphics.Vulkan
                 return;
             }
 
+            if (_prerotationEnabled && _currentScalingFilter != type)
+            {
+                // Whether the swapchain can be pre-rotated depends on the filter.
+                _swapchainIsDirty = true;
+            }
+
             _currentScalingFilter = type;
 
             _updateScalingFilter = true;
@@ -649,6 +782,35 @@ namespace Ryujinx.Graphics.Vulkan
             _swapchainIsDirty = true;
         }
 
+        public override void SetPresentQueueConfig(uint imageCount, ulong acquireTimeout)
+        {
+            if (_preferredImageCount != imageCount)
+            {
+                _preferredImageCount = imageCount;
+                _swapchainIsDirty = true;
+            }
+
+            _acquireTimeout = acquireTimeout;
+        }
+
+        public override void SetPrerotation(bool enabled)
+        {
+            if (_prerotationEnabled != enabled)
+            {
+                _prerotationEnabled = enabled;
+                _swapchainIsDirty = true;
+            }
+        }
+
+        public override void SetSharedPresent(bool enabled)
+        {
+            if (_sharedPresentEnabled != enabled)
+            {
+                _sharedPresentEnabled = enabled;
+                _swapchainIsDirty = true;
+            }
+        }
+
         public override void ChangeVSyncMode(bool vsyncEnabled)
         {
             _vsyncEnabled = vsyncEnabled;
@@ -10,6 +10,18 @@ namespace Ryujinx.Graphics.Vulkan
 
         public SurfaceTransformFlagsKHR CurrentTransform { get; set; }
 
+        public bool IsPrerotated { get; protected set; }
+
+        /// <summary>
+        /// Whether the swapchain presents from a single shared image in continuous refresh mode.
+        /// </summary>
+        public bool IsSharedPresent { get; protected set; }
+
+        /// <summary>
+        /// Whether the last present dropped its frame because no swapchain image was acquired in time.
+        /// </summary>
+        public bool IsFrameDropped { get; protected set; }
+
         public abstract void Dispose();
         public abstract void Present(ITexture texture, ImageCrop crop, Action swapBuffersCallback);
         public abstract void SetSize(int width, int height);
@@ -18,5 +30,8 @@ namespace Ryujinx.Graphics.Vulkan
         public abstract void SetScalingFilter(ScalingFilter scalerType);
         public abstract void SetScalingFilterLevel(float scale);
         public abstract void SetColorSpacePassthrough(bool colorSpacePassthroughEnabled);
+        public abstract void SetPresentQueueConfig(uint imageCount, ulong acquireTimeout);
+        public abstract void SetPrerotation(bool enabled);
+        public abstract void SetSharedPresent(bool enabled);
     }
 }
@@ -0,0 +1,139 @@
+#include "adaptive_turbo.h"
+#include "adrenotools/driver.h"
+#include <android/log.h>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#define TURBO_LOG(...) __android_log_print(ANDROID_LOG_INFO, "RyujinxAdaptiveTurbo", __VA_ARGS__)
+
+namespace {
+
+// Engage when this many frames of the last window missed the target
+constexpr int WindowFrames = 30;
+constexpr int EngageMissedFrames = 5;
+
+// Release once turbo has been held long enough and the average work time has this much headroom
+constexpr double ReleaseLoadRatio = 0.7;
+constexpr int ReleaseMaxMissedFrames = 1;
+constexpr int64_t MinHoldNs = 3'000'000'000;
+constexpr int64_t MaxHoldNs = 30'000'000'000;
+
+// Re-engaging this soon after a release means the headroom was only there because of turbo
+constexpr int64_t QuickReengageNs = 5'000'000'000;
+
+struct TurboGovernor {
+    bool enabled = false;
+    bool engaged = false;
+
+    bool missed[WindowFrames] = {};
+    int64_t work[WindowFrames] = {};
+    int index = 0;
+    int frames = 0;
+    int missedCount = 0;
+    int64_t workSum = 0;
+
+    int64_t holdNs = MinHoldNs;
+    int64_t engagedAtNs = 0;
+    int64_t releasedAtNs = 0;
+
+    void resetWindow() {
+        std::fill(std::begin(missed), std::end(missed), false);
+        std::fill(std::begin(work), std::end(work), 0);
+        index = 0;
+        frames = 0;
+        missedCount = 0;
+        workSum = 0;
+    }
+
+    void push(int64_t workNs, bool miss) {
+        missedCount += (miss ? 1 : 0) - (missed[index] ? 1 : 0);
+        workSum += workNs - work[index];
+        missed[index] = miss;
+        work[index] = workNs;
+        index = (index + 1) % WindowFrames;
+        frames = std::min(frames + 1, WindowFrames);
+    }
+};
+
+std::mutex _turboMutex;
+TurboGovernor _governor;
+std::atomic<bool> _turboEngaged = false;
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void applyTurbo(bool engage) {
+    _governor.engaged = engage;
+    _turboEngaged.store(engage);
+    adrenotools_set_turbo(engage);
+}
+
+}
+
+void setAdaptiveTurboEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(_turboMutex);
+
+    if (_governor.enabled == enabled)
+        return;
+
+    _governor.enabled = enabled;
+    _governor.resetWindow();
+    _governor.holdNs = MinHoldNs;
+
+    if (!enabled && _governor.engaged)
+        applyTurbo(false);
+}
+
+void onRenderFrameWorkDuration(int64_t workDurationNs, int64_t targetDurationNs) {
+    if (workDurationNs <= 0 || targetDurationNs <= 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_turboMutex);
+
+    auto &governor = _governor;
+    if (!governor.enabled)
+        return;
+
+    governor.push(workDurationNs, workDurationNs > targetDurationNs);
+    if (governor.frames < WindowFrames)
+        return;
+
+    auto now = nowNs();
+
+    if (!governor.engaged) {
+        if (governor.missedCount < EngageMissedFrames)
+            return;
+
+        if (governor.releasedAtNs != 0 && now - governor.releasedAtNs < QuickReengageNs)
+            governor.holdNs = std::min(governor.holdNs * 2, MaxHoldNs);
+        else
+            governor.holdNs = MinHoldNs;
+
+        governor.engagedAtNs = now;
+        governor.resetWindow();
+        applyTurbo(true);
+        TURBO_LOG("Turbo engaged, holding for at least %lld ms",
+                  static_cast<long long>(governor.holdNs / 1000000));
+        return;
+    }
+
+    if (now - governor.engagedAtNs < governor.holdNs)
+        return;
+
+    auto averageNs = governor.workSum / governor.frames;
+    if (governor.missedCount <= ReleaseMaxMissedFrames &&
+        averageNs <= static_cast<int64_t>(targetDurationNs * ReleaseLoadRatio)) {
+        governor.releasedAtNs = now;
+        governor.resetWindow();
+        applyTurbo(false);
+        TURBO_LOG("Turbo released");
+    }
+}
+
+bool isTurboEngaged() {
+    return _turboEngaged.load();
+}
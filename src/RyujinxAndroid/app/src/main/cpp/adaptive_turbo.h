@@ -0,0 +1,15 @@
+#ifndef RYUJINXNATIVE_ADAPTIVE_TURBO_H
+#define RYUJINXNATIVE_ADAPTIVE_TURBO_H
+
+#include <cstdint>
+
+// Engages adrenotools turbo only while frames miss their target, and drops it again
+// once there is sustained headroom. Disabling also releases turbo immediately.
+void setAdaptiveTurboEnabled(bool enabled);
+
+// Called once per rendered frame with the measured work time and the frame target
+void onRenderFrameWorkDuration(int64_t workDurationNs, int64_t targetDurationNs);
+
+bool isTurboEngaged();
+
+#endif //RYUJINXNATIVE_ADAPTIVE_TURBO_H
@@ -0,0 +1,171 @@
+#include "driver_registry.h"
+#include "adrenotools/driver.h"
+#include <android/log.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+#define DRIVER_LOG(...) __android_log_print(ANDROID_LOG_INFO, "RyujinxDriver", __VA_ARGS__)
+
+namespace {
+
+std::mutex _driversLock;
+// deque keeps entries in place as it grows
+std::deque<DriverInfo> _drivers;
+
+void hashValue(uint64_t &hash, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+}
+
+// FNV-1a over the size, modification time and inode. The app only rewrites the driver when it
+// changed, so a stat is enough to tell builds apart without reading the file.
+uint64_t fingerprintFile(const std::string &path) {
+    struct stat info{};
+    if (stat(path.c_str(), &info) != 0 || info.st_size <= 0)
+        return 0;
+
+    uint64_t hash = 14695981039346656037ull;
+    hashValue(hash, static_cast<uint64_t>(info.st_size));
+    hashValue(hash, static_cast<uint64_t>(info.st_mtim.tv_sec));
+    hashValue(hash, static_cast<uint64_t>(info.st_mtim.tv_nsec));
+    hashValue(hash, static_cast<uint64_t>(info.st_ino));
+    return hash;
+}
+
+// Creates a throwaway instance on the driver to read the properties of its first physical device
+void queryDriverProperties(DriverInfo &driver) {
+    auto getInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>(
+            dlsym(driver.handle, "vkGetInstanceProcAddr"));
+    if (!getInstanceProcAddr)
+        return;
+
+    auto createInstance = reinterpret_cast<PFN_vkCreateInstance>(
+            getInstanceProcAddr(nullptr, "vkCreateInstance"));
+    if (!createInstance)
+        return;
+
+    VkApplicationInfo appInfo{};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = "Ryujinx";
+    appInfo.apiVersion = VK_API_VERSION_1_1;
+
+    VkInstanceCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    createInfo.pApplicationInfo = &appInfo;
+
+    VkInstance instance = nullptr;
+    if (createInstance(&createInfo, nullptr, &instance) != VK_SUCCESS)
+        return;
+
+    auto destroyInstance = reinterpret_cast<PFN_vkDestroyInstance>(
+            getInstanceProcAddr(instance, "vkDestroyInstance"));
+    auto enumeratePhysicalDevices = reinterpret_cast<PFN_vkEnumeratePhysicalDevices>(
+            getInstanceProcAddr(instance, "vkEnumeratePhysicalDevices"));
+    auto getPhysicalDeviceProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties>(
+            getInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties"));
+    auto enumerateDeviceExtensionProperties = reinterpret_cast<PFN_vkEnumerateDeviceExtensionProperties>(
+            getInstanceProcAddr(instance, "vkEnumerateDeviceExtensionProperties"));
+
+    uint32_t deviceCount = 1;
+    VkPhysicalDevice physicalDevice = nullptr;
+    if (enumeratePhysicalDevices && getPhysicalDeviceProperties &&
+        enumeratePhysicalDevices(instance, &deviceCount, &physicalDevice) >= VK_SUCCESS &&
+        deviceCount > 0 && physicalDevice) {
+        VkPhysicalDeviceProperties properties{};
+        getPhysicalDeviceProperties(physicalDevice, &properties);
+
+        driver.apiVersion = properties.apiVersion;
+        driver.driverVersion = properties.driverVersion;
+        driver.vendorId = properties.vendorID;
+        driver.deviceId = properties.deviceID;
+        driver.deviceName = properties.deviceName;
+        std::copy(std::begin(properties.pipelineCacheUUID), std::end(properties.pipelineCacheUUID),
+                  driver.pipelineCacheUUID);
+        driver.propertiesValid = true;
+
+        uint32_t extensionCount = 0;
+        if (enumerateDeviceExtensionProperties &&
+            enumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr) == VK_SUCCESS) {
+            std::vector<VkExtensionProperties> extensions(extensionCount);
+            if (enumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount,
+                                                   extensions.data()) >= VK_SUCCESS) {
+                for (uint32_t i = 0; i < extensionCount; i++)
+                    driver.extensions.emplace_back(extensions[i].extensionName);
+            }
+        }
+    }
+
+    if (destroyInstance)
+        destroyInstance(instance, nullptr);
+}
+
+}
+
+const DriverInfo *openDriver(const char *libPath, const char *privateAppsPath, const char *driverName) {
+    std::lock_guard<std::mutex> guard(_driversLock);
+
+    auto start = std::chrono::steady_clock::now();
+    auto fingerprint = fingerprintFile(std::string(privateAppsPath) + driverName);
+
+    DriverInfo *stale = nullptr;
+    for (auto &driver: _drivers) {
+        if (driver.driverName != driverName || driver.libPath != libPath)
+            continue;
+
+        if (driver.fingerprint == fingerprint && fingerprint != 0) {
+            DRIVER_LOG("Reusing loaded driver %s", driverName);
+            return &driver;
+        }
+        stale = &driver;
+    }
+
+    auto handle = adrenotools_open_libvulkan(
+            RTLD_NOW,
+            ADRENOTOOLS_DRIVER_CUSTOM,
+            nullptr,
+            libPath,
+            privateAppsPath,
+            driverName,
+            nullptr,
+            nullptr
+    );
+    if (!handle)
+        return nullptr;
+
+    // A rebuilt driver under the same name takes over the entry of the old build
+    if (stale != nullptr) {
+        DRIVER_LOG("Driver %s changed, closing the previous build", driverName);
+        dlclose(stale->handle);
+        *stale = DriverInfo{};
+    }
+
+    auto &driver = stale != nullptr ? *stale : _drivers.emplace_back();
+    driver.driverName = driverName;
+    driver.libPath = libPath;
+    driver.handle = handle;
+    driver.fingerprint = fingerprint;
+    queryDriverProperties(driver);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    DRIVER_LOG("Loaded driver %s (%s, %zu extensions) in %lld ms", driverName,
+               driver.deviceName.c_str(), driver.extensions.size(), static_cast<long long>(elapsed));
+
+    return &driver;
+}
+
+const DriverInfo *findDriver(void *handle) {
+    std::lock_guard<std::mutex> guard(_driversLock);
+
+    for (auto &driver: _drivers) {
+        if (driver.handle == handle)
+            return &driver;
+    }
+    return nullptr;
+}
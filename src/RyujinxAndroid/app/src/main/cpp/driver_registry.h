@@ -0,0 +1,36 @@
+#ifndef RYUJINXNATIVE_DRIVER_REGISTRY_H
+#define RYUJINXNATIVE_DRIVER_REGISTRY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "vulkan_wrapper.h"
+
+// A custom driver opened through adrenotools, kept open until a different build of it is opened.
+// Entries are never removed, a new build reuses the entry of the old one, so pointers to them
+// stay valid.
+struct DriverInfo {
+    std::string driverName;
+    std::string libPath;
+    void *handle = nullptr;
+    // Identifies the driver binary, the same name can be reused by different driver builds
+    uint64_t fingerprint = 0;
+
+    bool propertiesValid = false;
+    uint32_t apiVersion = 0;
+    uint32_t driverVersion = 0;
+    uint32_t vendorId = 0;
+    uint32_t deviceId = 0;
+    std::string deviceName;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE] = {};
+    std::vector<std::string> extensions;
+};
+
+// Returns the cached driver for (driverName, libPath) when the driver file is unchanged,
+// otherwise opens it with adrenotools and records its properties, closing the handle of a
+// previous build with the same name. Null if it fails to open.
+const DriverInfo *openDriver(const char *libPath, const char *privateAppsPath, const char *driverName);
+
+const DriverInfo *findDriver(void *handle);
+
+#endif //RYUJINXNATIVE_DRIVER_REGISTRY_H
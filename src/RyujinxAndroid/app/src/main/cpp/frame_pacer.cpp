@@ -0,0 +1,315 @@
+#include "frame_pacer.h"
+#include "native_window.h"
+#include <android/log.h>
+#include <android/native_window.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+#define PACER_LOG(...) __android_log_print(ANDROID_LOG_INFO, "RyujinxFramePacer", __VA_ARGS__)
+
+namespace {
+
+/**
+ * @url https://cs.android.com/android/platform/superproject/+/android11-release:frameworks/native/libs/nativewindow/include/system/window.h;l=320-323;drc=401cda638e7d17f6697b5a65c9a5ad79d056202d
+ */
+constexpr int64_t NativeWindowTimestampPending{-2};
+constexpr int64_t NativeWindowTimestampInvalid{-1};
+
+constexpr int FrameHistory = 8;
+constexpr int MaxSwapMultiple = 4;
+// Frames the measured interval must disagree with the current multiple before switching
+constexpr int SwapMultipleSwitchFrames = 10;
+// Refresh rate can change with the display mode, so it is re-read periodically
+constexpr int RefreshQueryInterval = 60;
+constexpr double IntervalSmoothing = 0.1;
+// Guest frame rates the surface frame rate snaps to, anything else is left to the compositor
+constexpr float GuestFrameRates[] = {20.0f, 24.0f, 25.0f, 30.0f, 40.0f, 48.0f, 50.0f, 60.0f};
+constexpr float GuestFrameRateTolerance = 0.08f;
+// Frames a new guest frame rate must hold before the surface is told about it
+constexpr int FrameRateSwitchFrames = 30;
+
+struct FramePacer {
+    ANativeWindow *window = nullptr;
+    bool enabled = false;
+    bool supported = false;
+
+    int64_t refreshPeriodNs = 0;
+    int64_t compositeToPresentLatencyNs = 0;
+    int framesSinceRefreshQuery = 0;
+
+    uint64_t frameIds[FrameHistory] = {};
+    int frameCount = 0;
+
+    int64_t lastPresentCallNs = 0;
+    double frameIntervalNs = 0.0;
+
+    float frameRate = 0.0f;
+    float pendingFrameRate = 0.0f;
+    int pendingFrameRateFrames = 0;
+
+    int swapMultiple = 1;
+    int pendingSwapMultiple = 1;
+    int pendingSwapFrames = 0;
+
+    // Latest actual display present time and the vsync it anchors
+    int64_t anchorPresentNs = 0;
+    int64_t lastDesiredPresentNs = 0;
+};
+
+FramePacer _pacer;
+std::atomic_bool _pacingEnabled = true;
+std::atomic_bool _frameRateMatching = true;
+std::atomic<float> _guestFrameRate = 0.0f;
+std::atomic<int64_t> _refreshPeriodNs = 0;
+std::atomic<int32_t> _swapMultiple = 0;
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void queryDisplayTiming(FramePacer &pacer) {
+    int64_t refreshPeriod = 0;
+    if (pacer.window->perform(pacer.window, NATIVE_WINDOW_GET_REFRESH_CYCLE_DURATION,
+                              &refreshPeriod) == 0 && refreshPeriod > 0) {
+        pacer.refreshPeriodNs = refreshPeriod;
+        _refreshPeriodNs.store(refreshPeriod);
+    }
+
+    int64_t compositeDeadline = 0, compositeInterval = 0, compositeToPresentLatency = 0;
+    if (pacer.window->perform(pacer.window, NATIVE_WINDOW_GET_COMPOSITOR_TIMING, &compositeDeadline,
+                              &compositeInterval, &compositeToPresentLatency) == 0 &&
+        compositeToPresentLatency > 0)
+        pacer.compositeToPresentLatencyNs = compositeToPresentLatency;
+
+    pacer.framesSinceRefreshQuery = 0;
+}
+
+void attach(FramePacer &pacer, ANativeWindow *window) {
+    pacer = FramePacer();
+    pacer.window = window;
+
+    _guestFrameRate.store(0.0f);
+
+    pacer.supported = window->perform(window, NATIVE_WINDOW_ENABLE_FRAME_TIMESTAMPS, true) == 0;
+    if (!pacer.supported) {
+        PACER_LOG("Frame timestamps are not supported, pacing disabled");
+        return;
+    }
+
+    queryDisplayTiming(pacer);
+    PACER_LOG("Refresh period %lld ns", static_cast<long long>(pacer.refreshPeriodNs));
+}
+
+// Walks back from the newest frame to find the latest one the display has shown
+void updateAnchor(FramePacer &pacer) {
+    int count = std::min(pacer.frameCount, FrameHistory);
+    for (int i = 1; i <= count; i++) {
+        auto frameId = pacer.frameIds[(pacer.frameCount - i) % FrameHistory];
+
+        int64_t requestedPresent = 0, acquire = 0, latch = 0, firstRefreshStart = 0,
+                lastRefreshStart = 0, gpuCompositionDone = 0, displayPresent = 0,
+                dequeueReady = 0, release = 0;
+        if (pacer.window->perform(pacer.window, NATIVE_WINDOW_GET_FRAME_TIMESTAMPS, frameId,
+                                  &requestedPresent, &acquire, &latch, &firstRefreshStart,
+                                  &lastRefreshStart, &gpuCompositionDone, &displayPresent,
+                                  &dequeueReady, &release) != 0)
+            continue;
+
+        if (displayPresent == NativeWindowTimestampPending ||
+            displayPresent == NativeWindowTimestampInvalid || displayPresent <= 0)
+            continue;
+
+        pacer.anchorPresentNs = std::max(pacer.anchorPresentNs, displayPresent);
+        return;
+    }
+}
+
+void updateSwapMultiple(FramePacer &pacer) {
+    if (pacer.refreshPeriodNs <= 0 || pacer.frameIntervalNs <= 0.0)
+        return;
+
+    int target = static_cast<int>(std::lround(pacer.frameIntervalNs / pacer.refreshPeriodNs));
+    target = std::clamp(target, 1, MaxSwapMultiple);
+
+    if (target == pacer.swapMultiple) {
+        pacer.pendingSwapFrames = 0;
+        return;
+    }
+
+    if (target != pacer.pendingSwapMultiple) {
+        pacer.pendingSwapMultiple = target;
+        pacer.pendingSwapFrames = 0;
+    }
+
+    if (++pacer.pendingSwapFrames >= SwapMultipleSwitchFrames) {
+        pacer.swapMultiple = target;
+        pacer.pendingSwapFrames = 0;
+    }
+}
+
+// Neighbouring candidates such as 24/25 and 48/50 overlap within the tolerance,
+// so the nearest one wins rather than the first
+constexpr float snapFrameRate(double frameIntervalNs) {
+    if (frameIntervalNs <= 0.0)
+        return 0.0f;
+
+    auto frameRate = static_cast<float>(1e9 / frameIntervalNs);
+    float snapped = 0.0f;
+    float snappedDistance = 0.0f;
+    for (auto candidate: GuestFrameRates) {
+        auto distance = frameRate > candidate ? frameRate - candidate : candidate - frameRate;
+        if (distance <= candidate * GuestFrameRateTolerance &&
+            (snapped == 0.0f || distance < snappedDistance)) {
+            snapped = candidate;
+            snappedDistance = distance;
+        }
+    }
+
+    return snapped;
+}
+
+static_assert(snapFrameRate(1e9 / 24.0) == 24.0f);
+static_assert(snapFrameRate(1e9 / 25.0) == 25.0f);
+static_assert(snapFrameRate(1e9 / 48.0) == 48.0f);
+static_assert(snapFrameRate(1e9 / 50.0) == 50.0f);
+static_assert(snapFrameRate(1e9 / 59.2) == 60.0f);
+static_assert(snapFrameRate(1e9 / 35.0) == 0.0f);
+
+// Tells the compositor the guest cadence so it can pick a refresh rate that is a whole multiple of it
+void updateFrameRate(FramePacer &pacer) {
+    bool matching = _frameRateMatching.load(std::memory_order_relaxed);
+    auto frameRate = matching ? snapFrameRate(pacer.frameIntervalNs) : 0.0f;
+
+    // Unknown cadences (loading screens, frame spikes) keep the current vote
+    if ((matching && frameRate == 0.0f) || frameRate == pacer.frameRate) {
+        pacer.pendingFrameRateFrames = 0;
+        return;
+    }
+
+    if (frameRate != pacer.pendingFrameRate) {
+        pacer.pendingFrameRate = frameRate;
+        pacer.pendingFrameRateFrames = 0;
+    }
+
+    // A new rate has to hold for a while, clearing the vote applies immediately
+    if (frameRate != 0.0f && ++pacer.pendingFrameRateFrames < FrameRateSwitchFrames)
+        return;
+
+    // 0 removes the vote and lets the compositor decide again
+    if (ANativeWindow_setFrameRate(pacer.window, frameRate,
+                                   ANATIVEWINDOW_FRAME_RATE_COMPATIBILITY_DEFAULT) == 0) {
+        PACER_LOG("Surface frame rate set to %.0f", frameRate);
+        pacer.frameRate = frameRate;
+        _guestFrameRate.store(frameRate);
+    }
+    pacer.pendingFrameRateFrames = 0;
+}
+
+int64_t scheduleNextPresent(FramePacer &pacer, int64_t now) {
+    auto period = pacer.refreshPeriodNs;
+    auto cadence = period * pacer.swapMultiple;
+
+    // Earliest vsync the next buffer can still make
+    auto earliest = now + std::max(pacer.compositeToPresentLatencyNs, period);
+
+    auto desired = pacer.lastDesiredPresentNs != 0 ? pacer.lastDesiredPresentNs + cadence : earliest;
+    if (desired < earliest)
+        desired += ((earliest - desired + cadence - 1) / cadence) * cadence;
+    // Frames arriving faster than the cadence would otherwise pile up latency
+    else if (desired > earliest + cadence)
+        desired = earliest;
+
+    // Snap onto the vsync grid of the last frame actually shown
+    if (pacer.anchorPresentNs > 0) {
+        auto phase = (desired - pacer.anchorPresentNs) % period;
+        if (phase < 0)
+            phase += period;
+        desired -= phase;
+        if (phase > period / 2)
+            desired += period;
+        if (desired < earliest)
+            desired += cadence;
+    }
+
+    return desired;
+}
+
+}
+
+void framePacerOnFramePresented(ANativeWindow *window) {
+    if (window == nullptr)
+        return;
+
+    auto &pacer = _pacer;
+    if (pacer.window != window)
+        attach(pacer, window);
+
+    auto now = nowNs();
+    if (pacer.lastPresentCallNs != 0) {
+        auto interval = static_cast<double>(now - pacer.lastPresentCallNs);
+        pacer.frameIntervalNs = pacer.frameIntervalNs == 0.0
+                                ? interval
+                                : pacer.frameIntervalNs + (interval - pacer.frameIntervalNs) * IntervalSmoothing;
+    }
+    pacer.lastPresentCallNs = now;
+
+    updateFrameRate(pacer);
+
+    if (!pacer.supported)
+        return;
+
+    bool enabled = _pacingEnabled.load(std::memory_order_relaxed);
+    if (enabled != pacer.enabled) {
+        pacer.enabled = enabled;
+        pacer.lastDesiredPresentNs = 0;
+        if (!enabled) {
+            _swapMultiple.store(0);
+            window->perform(window, NATIVE_WINDOW_SET_BUFFERS_TIMESTAMP, NativeWindowTimestampAuto);
+        }
+    }
+
+    if (!enabled)
+        return;
+
+    if (++pacer.framesSinceRefreshQuery >= RefreshQueryInterval)
+        queryDisplayTiming(pacer);
+
+    updateAnchor(pacer);
+    updateSwapMultiple(pacer);
+
+    // Id of the buffer that will be queued next, so its timestamps can be read back later
+    uint64_t nextFrameId = 0;
+    if (window->perform(window, NATIVE_WINDOW_GET_NEXT_FRAME_ID, &nextFrameId) == 0)
+        pacer.frameIds[pacer.frameCount++ % FrameHistory] = nextFrameId;
+
+    if (pacer.refreshPeriodNs <= 0)
+        return;
+
+    auto desired = scheduleNextPresent(pacer, now);
+    pacer.lastDesiredPresentNs = desired;
+    window->perform(window, NATIVE_WINDOW_SET_BUFFERS_TIMESTAMP, desired);
+    _swapMultiple.store(pacer.swapMultiple);
+}
+
+void framePacerSetEnabled(bool enabled) {
+    _pacingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void framePacerSetFrameRateMatching(bool enabled) {
+    _frameRateMatching.store(enabled, std::memory_order_relaxed);
+}
+
+float framePacerGetGuestFrameRate() {
+    return _guestFrameRate.load();
+}
+
+int64_t framePacerGetRefreshPeriod() {
+    return _refreshPeriodNs.load();
+}
+
+int32_t framePacerGetSwapMultiple() {
+    return _swapMultiple.load();
+}
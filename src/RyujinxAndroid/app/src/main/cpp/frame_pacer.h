@@ -0,0 +1,33 @@
+#ifndef RYUJINXNATIVE_FRAME_PACER_H
+#define RYUJINXNATIVE_FRAME_PACER_H
+
+#include <cstdint>
+
+struct ANativeWindow;
+
+// Paces presents onto whole multiples of the display refresh period, so that for example
+// a 30 fps game on a 90 Hz panel lands on every third vsync instead of alternating 2 and 4.
+
+// Called after each present. Reads back the timestamps of completed frames and schedules
+// the desired present time of the next queued buffer.
+// Must be called from the thread that presents to the window.
+void framePacerOnFramePresented(ANativeWindow *window);
+
+// Can be called from any thread; takes effect on the next present. Disabling returns the
+// window to automatic timestamps.
+void framePacerSetEnabled(bool enabled);
+
+// Lets the pacer forward the detected guest cadence to ANativeWindow_setFrameRate.
+// Can be called from any thread; disabling clears the surface frame rate on the next present.
+void framePacerSetFrameRateMatching(bool enabled);
+
+// Frame rate last applied to the surface, 0 if none
+float framePacerGetGuestFrameRate();
+
+// Refresh period reported by the compositor, 0 if unknown
+int64_t framePacerGetRefreshPeriod();
+
+// Number of refresh periods each frame is currently held for, 0 while not pacing
+int32_t framePacerGetSwapMultiple();
+
+#endif //RYUJINXNATIVE_FRAME_PACER_H
@@ -0,0 +1,122 @@
+#include "java_bridge.h"
+#include <android/log.h>
+#include <android/thermal.h>
+#include <pthread.h>
+#include <atomic>
+
+#define BRIDGE_LOG(...) __android_log_print(ANDROID_LOG_INFO, "RyujinxJavaBridge", __VA_ARGS__)
+
+namespace {
+
+JavaVM *_bridgeVm = nullptr;
+jclass _callbackClass = nullptr;
+jmethodID _onNativeEvents = nullptr;
+// Reused by every flush, the Java side copies the values out before returning
+jlongArray _eventArray = nullptr;
+
+pthread_key_t _detachKey;
+pthread_once_t _detachKeyOnce = PTHREAD_ONCE_INIT;
+thread_local JNIEnv *_threadEnv = nullptr;
+
+std::atomic<int64_t> _eventValues[NATIVE_EVENT_COUNT];
+std::atomic<uint32_t> _changedEvents = 0;
+
+AThermalManager *_thermalManager = nullptr;
+
+void detachThread(void *) {
+    _bridgeVm->DetachCurrentThread();
+}
+
+void createDetachKey() {
+    pthread_key_create(&_detachKey, detachThread);
+}
+
+void onThermalStatusChanged(void *, AThermalStatus status) {
+    javaBridgePostEvent(NATIVE_EVENT_THERMAL_STATUS, status);
+}
+
+}
+
+void javaBridgeInit(JNIEnv *env, jclass callbackClass) {
+    if (_bridgeVm != nullptr)
+        return;
+
+    env->GetJavaVM(&_bridgeVm);
+    _threadEnv = env;
+
+    _callbackClass = (jclass) env->NewGlobalRef(callbackClass);
+    _onNativeEvents = env->GetStaticMethodID(_callbackClass, "onNativeEvents", "([J)V");
+    if (_onNativeEvents == nullptr) {
+        env->ExceptionClear();
+        BRIDGE_LOG("onNativeEvents not found, native events are disabled");
+    }
+
+    auto eventArray = env->NewLongArray(NATIVE_EVENT_COUNT + 1);
+    _eventArray = (jlongArray) env->NewGlobalRef(eventArray);
+    env->DeleteLocalRef(eventArray);
+
+    _thermalManager = AThermal_acquireManager();
+    if (_thermalManager != nullptr) {
+        javaBridgePostEvent(NATIVE_EVENT_THERMAL_STATUS,
+                            AThermal_getCurrentThermalStatus(_thermalManager));
+        AThermal_registerThermalStatusListener(_thermalManager, onThermalStatusChanged, nullptr);
+    }
+}
+
+JNIEnv *javaBridgeGetEnv() {
+    if (_threadEnv != nullptr)
+        return _threadEnv;
+
+    if (_bridgeVm == nullptr)
+        return nullptr;
+
+    JNIEnv *env = nullptr;
+
+    // Threads created by Java are already attached and must not be detached by us
+    if (_bridgeVm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_OK) {
+        _threadEnv = env;
+        return env;
+    }
+
+    char name[16] = "RyujinxNative";
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+
+    JavaVMAttachArgs args{.version = JNI_VERSION_1_6, .name = name, .group = nullptr};
+    if (_bridgeVm->AttachCurrentThread(&env, &args) != JNI_OK) {
+        BRIDGE_LOG("Failed to attach thread %s", name);
+        return nullptr;
+    }
+
+    pthread_once(&_detachKeyOnce, createDetachKey);
+    pthread_setspecific(_detachKey, env);
+
+    _threadEnv = env;
+    return env;
+}
+
+void javaBridgePostEvent(NativeEvent event, int64_t value) {
+    if (_eventValues[event].exchange(value, std::memory_order_relaxed) != value)
+        _changedEvents.fetch_or(1u << event, std::memory_order_release);
+}
+
+void javaBridgeFlush() {
+    if (_onNativeEvents == nullptr || _changedEvents.load(std::memory_order_relaxed) == 0)
+        return;
+
+    auto env = javaBridgeGetEnv();
+    if (env == nullptr)
+        return;
+
+    jlong values[NATIVE_EVENT_COUNT + 1];
+    values[0] = _changedEvents.exchange(0, std::memory_order_acquire);
+    for (int i = 0; i < NATIVE_EVENT_COUNT; i++)
+        values[i + 1] = _eventValues[i].load(std::memory_order_relaxed);
+
+    env->SetLongArrayRegion(_eventArray, 0, NATIVE_EVENT_COUNT + 1, values);
+    env->CallStaticVoidMethod(_callbackClass, _onNativeEvents, _eventArray);
+
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+}
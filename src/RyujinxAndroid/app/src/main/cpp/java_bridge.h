@@ -0,0 +1,43 @@
+#ifndef RYUJINXNATIVE_JAVA_BRIDGE_H
+#define RYUJINXNATIVE_JAVA_BRIDGE_H
+
+#include <cstdint>
+#include <jni.h>
+
+// Calls back into Java from native threads. Each thread is attached to the VM once and
+// detached when it exits, and the callback class and method are resolved once at startup,
+// since FindClass on an attached native thread can't see the app's classes.
+
+// Values delivered to MainActivity.onNativeEvents. The array passed there holds a bitmask of
+// the events that changed since the last call, followed by the latest value of every event.
+enum NativeEvent {
+    // p95 time spent waiting for a free swapchain buffer, in nanoseconds
+    NATIVE_EVENT_PRESENT_WAIT = 0,
+    // Guest frame rate matched to the surface, in millihertz, 0 if none
+    NATIVE_EVENT_GUEST_FRAME_RATE,
+    // Refresh periods each frame is held for, 0 while not pacing
+    NATIVE_EVENT_SWAP_MULTIPLE,
+    // Underruns of the audio stream since it was initialized, posted by the audio renderer
+    // through postNativeEvent. The renderer hardcodes this index in audio_host_hooks.h.
+    NATIVE_EVENT_AUDIO_UNDERRUNS = 3,
+    // Time from the last present until audio written now is heard, in nanoseconds
+    NATIVE_EVENT_AUDIO_LATENCY,
+    // AThermalStatus of the device
+    NATIVE_EVENT_THERMAL_STATUS,
+    NATIVE_EVENT_COUNT
+};
+
+// Called once from a Java thread, with the class declaring the static onNativeEvents([J)V
+void javaBridgeInit(JNIEnv *env, jclass callbackClass);
+
+// JNIEnv of the calling thread, attaching it if needed. nullptr before javaBridgeInit.
+JNIEnv *javaBridgeGetEnv();
+
+// Can be called from any thread, only the latest value of each event is delivered
+void javaBridgePostEvent(NativeEvent event, int64_t value);
+
+// Delivers the changed events with a single JNI call, does nothing if nothing changed.
+// Called once per frame from the presenting thread.
+void javaBridgeFlush();
+
+#endif //RYUJINXNATIVE_JAVA_BRIDGE_H
@@ -0,0 +1,36 @@
+#ifndef RYUJINXNATIVE_NATIVE_TRACE_H
+#define RYUJINXNATIVE_NATIVE_TRACE_H
+
+// ATrace sections and counters that show up in Perfetto captures. Only compiled in when
+// RYUJINX_TRACE is defined (configure with -DRYUJINX_ENABLE_TRACE=ON), otherwise the macros
+// expand to nothing. Counter values are only evaluated while a trace is being captured.
+#ifdef RYUJINX_TRACE
+
+#include <android/trace.h>
+
+struct NativeTraceScope {
+    explicit NativeTraceScope(const char *name) { ATrace_beginSection(name); }
+
+    ~NativeTraceScope() { ATrace_endSection(); }
+
+    NativeTraceScope(const NativeTraceScope &) = delete;
+
+    NativeTraceScope &operator=(const NativeTraceScope &) = delete;
+};
+
+#define NATIVE_TRACE_CONCAT_INNER(a, b) a##b
+#define NATIVE_TRACE_CONCAT(a, b) NATIVE_TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) NativeTraceScope NATIVE_TRACE_CONCAT(_traceScope, __LINE__)(name)
+#define TRACE_COUNTER(name, value) \
+    do { \
+        if (ATrace_isEnabled()) ATrace_setCounter(name, (int64_t) (value)); \
+    } while (0)
+
+#else
+
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_COUNTER(name, value) do {} while (0)
+
+#endif
+
+#endif //RYUJINXNATIVE_NATIVE_TRACE_H
@@ -0,0 +1,224 @@
+#include "pipeline_cache.h"
+#include <android/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CACHE_LOG(...) __android_log_print(ANDROID_LOG_INFO, "RyujinxPipelineCache", __VA_ARGS__)
+
+namespace {
+
+constexpr auto WriteBackInterval = std::chrono::seconds(10);
+// Growth below this is left for the next interval or the final write
+constexpr size_t MinWriteBackGrowth = 64 * 1024;
+
+// VkPipelineCacheHeaderVersionOne: header size, version, vendor id, device id, then the UUID
+constexpr size_t CacheHeaderSize = 16 + VK_UUID_SIZE;
+constexpr size_t CacheHeaderUuidOffset = 16;
+
+std::mutex _cacheLock;
+std::string _directory;
+std::string _driverName = "system";
+std::string _path;
+
+void *_mappedData = nullptr;
+size_t _mappedSize = 0;
+
+VkDevice _device = VK_NULL_HANDLE;
+VkPipelineCache _cache = VK_NULL_HANDLE;
+PFN_vkGetPipelineCacheData _getPipelineCacheData = nullptr;
+size_t _writtenSize = 0;
+
+std::thread _writer;
+std::condition_variable _writerWake;
+bool _writerStop = false;
+
+std::string sanitize(const std::string &name) {
+    std::string result;
+    for (auto c: name)
+        result += (isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-') ? c : '_';
+    return result;
+}
+
+std::string cachePath(const uint8_t uuid[VK_UUID_SIZE]) {
+    static const char hex[] = "0123456789abcdef";
+    std::string uuidString;
+    for (int i = 0; i < VK_UUID_SIZE; i++) {
+        uuidString += hex[uuid[i] >> 4];
+        uuidString += hex[uuid[i] & 0xF];
+    }
+    return _directory + "/" + sanitize(_driverName) + "_" + uuidString + ".bin";
+}
+
+void unmapCache() {
+    if (_mappedData != nullptr)
+        munmap(_mappedData, _mappedSize);
+    _mappedData = nullptr;
+    _mappedSize = 0;
+}
+
+// Writes to a temporary file and renames it over the old one, so a crash mid-write never
+// leaves a truncated cache behind
+bool writeFile(const std::string &path, const std::vector<uint8_t> &data) {
+    auto temporaryPath = path + ".tmp";
+    int fd = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+
+    size_t written = 0;
+    while (written < data.size()) {
+        auto result = write(fd, data.data() + written, data.size() - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            break;
+        written += static_cast<size_t>(result);
+    }
+
+    bool success = written == data.size() && fsync(fd) == 0;
+    close(fd);
+
+    if (success)
+        success = rename(temporaryPath.c_str(), path.c_str()) == 0;
+    if (!success)
+        unlink(temporaryPath.c_str());
+    return success;
+}
+
+// Called with _cacheLock held
+void writeBack(bool force) {
+    if (_cache == VK_NULL_HANDLE || _getPipelineCacheData == nullptr || _path.empty())
+        return;
+
+    size_t size = 0;
+    if (_getPipelineCacheData(_device, _cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return;
+
+    if (size == _writtenSize || (!force && size < _writtenSize + MinWriteBackGrowth))
+        return;
+
+    std::vector<uint8_t> data(size);
+    if (_getPipelineCacheData(_device, _cache, &size, data.data()) < VK_SUCCESS)
+        return;
+    data.resize(size);
+
+    if (writeFile(_path, data)) {
+        _writtenSize = size;
+        CACHE_LOG("Wrote %zu bytes to %s", size, _path.c_str());
+    }
+}
+
+void writerLoop() {
+    std::unique_lock<std::mutex> lock(_cacheLock);
+    while (!_writerStop) {
+        _writerWake.wait_for(lock, WriteBackInterval);
+        if (!_writerStop)
+            writeBack(false);
+    }
+}
+
+}
+
+void setPipelineCacheDirectory(const char *path) {
+    std::lock_guard<std::mutex> guard(_cacheLock);
+
+    _directory = path;
+    mkdir(_directory.c_str(), 0700);
+}
+
+void setPipelineCacheDriverName(const char *driverName) {
+    std::lock_guard<std::mutex> guard(_cacheLock);
+
+    _driverName = driverName != nullptr && driverName[0] != '\0' ? driverName : "system";
+}
+
+bool pipelineCacheLoad(const uint8_t uuid[VK_UUID_SIZE], const void **data, size_t *size) {
+    std::lock_guard<std::mutex> guard(_cacheLock);
+
+    *data = nullptr;
+    *size = 0;
+    unmapCache();
+
+    if (_directory.empty())
+        return false;
+
+    _path = cachePath(uuid);
+    _writtenSize = 0;
+
+    int fd = open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < CacheHeaderSize) {
+        close(fd);
+        return false;
+    }
+
+    auto mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    _mappedData = mapped;
+    _mappedSize = static_cast<size_t>(info.st_size);
+
+    // The driver validates the blob as well, this only catches files renamed by hand
+    if (memcmp(static_cast<const uint8_t *>(mapped) + CacheHeaderUuidOffset, uuid, VK_UUID_SIZE) != 0) {
+        unmapCache();
+        return false;
+    }
+
+    _writtenSize = _mappedSize;
+    *data = _mappedData;
+    *size = _mappedSize;
+    CACHE_LOG("Loaded %zu bytes from %s", _mappedSize, _path.c_str());
+    return true;
+}
+
+void pipelineCacheAttach(VkDevice device, VkPipelineCache cache) {
+    pipelineCacheDetach();
+
+    std::lock_guard<std::mutex> guard(_cacheLock);
+
+    // The driver copied the initial data when the cache was created
+    unmapCache();
+
+    _device = device;
+    _cache = cache;
+    _getPipelineCacheData = reinterpret_cast<PFN_vkGetPipelineCacheData>(
+            GetVulkanDeviceFunction(device, "vkGetPipelineCacheData"));
+
+    if (_getPipelineCacheData == nullptr || _path.empty())
+        return;
+
+    _writerStop = false;
+    _writer = std::thread(writerLoop);
+}
+
+void pipelineCacheDetach() {
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> guard(_cacheLock);
+        _writerStop = true;
+        writer = std::move(_writer);
+    }
+    _writerWake.notify_all();
+    if (writer.joinable())
+        writer.join();
+
+    std::lock_guard<std::mutex> guard(_cacheLock);
+    writeBack(true);
+    _device = VK_NULL_HANDLE;
+    _cache = VK_NULL_HANDLE;
+    _getPipelineCacheData = nullptr;
+}
@@ -0,0 +1,28 @@
+#ifndef RYUJINXNATIVE_PIPELINE_CACHE_H
+#define RYUJINXNATIVE_PIPELINE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "vulkan_wrapper.h"
+
+// Keeps the renderer's VkPipelineCache on disk, one file per driver identity
+// (adrenotools driver name plus pipelineCacheUUID), so switching drivers never feeds
+// a cache blob to the wrong driver and switching back finds the old one again.
+
+void setPipelineCacheDirectory(const char *path);
+
+// Name of the active driver, "system" when none of the custom drivers is loaded
+void setPipelineCacheDriverName(const char *driverName);
+
+// Maps the stored cache for this driver. The data stays mapped until pipelineCacheAttach.
+// Returns false when there is no usable cache.
+bool pipelineCacheLoad(const uint8_t uuid[VK_UUID_SIZE], const void **data, size_t *size);
+
+// Starts writing the cache back in the background whenever it has grown
+void pipelineCacheAttach(VkDevice device, VkPipelineCache cache);
+
+// Writes the cache a last time and stops the background writer. Must be called before the
+// cache is destroyed.
+void pipelineCacheDetach();
+
+#endif //RYUJINXNATIVE_PIPELINE_CACHE_H
@@ -0,0 +1,82 @@
+#include "present_stats.h"
+#include "native_window.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+constexpr int SampleCapacity = 512;
+
+enum Series {
+    SeriesDequeue,
+    SeriesQueue,
+    SeriesHold,
+    SeriesCount
+};
+
+// Single writer ring. Readers copy it without locking, so a snapshot can mix in a sample
+// written during the copy, which does not matter for percentiles.
+std::atomic<int64_t> _samples[SeriesCount][SampleCapacity];
+std::atomic<uint64_t> _sampleCount = 0;
+std::atomic<uint64_t> _resetCount = 0;
+
+int64_t percentile(int64_t *values, int count, int percent) {
+    if (count == 0)
+        return 0;
+
+    auto index = std::min(count - 1, (count * percent) / 100);
+    std::nth_element(values, values + index, values + count);
+    return values[index];
+}
+
+}
+
+void samplePresentStats(ANativeWindow *window) {
+    if (window == nullptr)
+        return;
+
+    int64_t dequeueDuration = 0, queueDuration = 0, dequeueStart = 0;
+    if (window->perform(window, NATIVE_WINDOW_GET_LAST_DEQUEUE_DURATION, &dequeueDuration) != 0 ||
+        window->perform(window, NATIVE_WINDOW_GET_LAST_QUEUE_DURATION, &queueDuration) != 0)
+        return;
+
+    int64_t holdDuration = 0;
+    if (window->perform(window, NATIVE_WINDOW_GET_LAST_DEQUEUE_START, &dequeueStart) == 0 &&
+        dequeueStart > 0) {
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        holdDuration = std::max<int64_t>(0, now - dequeueStart - dequeueDuration);
+    }
+
+    auto count = _sampleCount.load(std::memory_order_relaxed);
+    auto slot = count % SampleCapacity;
+    _samples[SeriesDequeue][slot].store(dequeueDuration, std::memory_order_relaxed);
+    _samples[SeriesQueue][slot].store(queueDuration, std::memory_order_relaxed);
+    _samples[SeriesHold][slot].store(holdDuration, std::memory_order_relaxed);
+    _sampleCount.store(count + 1, std::memory_order_release);
+}
+
+void getPresentStats(int64_t out[PRESENT_STATS_COUNT]) {
+    auto total = _sampleCount.load(std::memory_order_acquire);
+    auto count = total - std::min(total, _resetCount.load(std::memory_order_relaxed));
+    auto samples = static_cast<int>(std::min<uint64_t>(count, SampleCapacity));
+    auto first = total - samples;
+
+    out[PRESENT_STATS_SAMPLE_COUNT] = static_cast<int64_t>(count);
+
+    int64_t values[SampleCapacity];
+    for (int series = 0; series < SeriesCount; series++) {
+        for (int i = 0; i < samples; i++)
+            values[i] = _samples[series][(first + i) % SampleCapacity].load(std::memory_order_relaxed);
+
+        auto base = PRESENT_STATS_DEQUEUE_P50 + series * 3;
+        out[base] = percentile(values, samples, 50);
+        out[base + 1] = percentile(values, samples, 95);
+        out[base + 2] = percentile(values, samples, 99);
+    }
+}
+
+void resetPresentStats() {
+    _resetCount.store(_sampleCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
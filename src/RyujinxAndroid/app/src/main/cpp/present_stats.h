@@ -0,0 +1,34 @@
+#ifndef RYUJINXNATIVE_PRESENT_STATS_H
+#define RYUJINXNATIVE_PRESENT_STATS_H
+
+#include <cstdint>
+
+struct ANativeWindow;
+
+// Layout of the array filled by getPresentStats. Durations are in nanoseconds.
+// Dequeue is time blocked waiting for a free buffer (BufferQueue backpressure), queue is time
+// spent handing the buffer to the compositor, and hold is the time from the start of the last
+// dequeue to the present, which covers rendering into the buffer.
+enum PresentStatsIndex {
+    PRESENT_STATS_SAMPLE_COUNT = 0,
+    PRESENT_STATS_DEQUEUE_P50,
+    PRESENT_STATS_DEQUEUE_P95,
+    PRESENT_STATS_DEQUEUE_P99,
+    PRESENT_STATS_QUEUE_P50,
+    PRESENT_STATS_QUEUE_P95,
+    PRESENT_STATS_QUEUE_P99,
+    PRESENT_STATS_HOLD_P50,
+    PRESENT_STATS_HOLD_P95,
+    PRESENT_STATS_HOLD_P99,
+    PRESENT_STATS_COUNT
+};
+
+// Called from the presenting thread after each present
+void samplePresentStats(ANativeWindow *window);
+
+// Percentiles over the most recent presents, can be called from any thread
+void getPresentStats(int64_t out[PRESENT_STATS_COUNT]);
+
+void resetPresentStats();
+
+#endif //RYUJINXNATIVE_PRESENT_STATS_H
@@ -18,12 +18,28 @@
 
 #include "ryuijnx.h"
 #include "pthread.h"
+#include "thread_tuning.h"
+#include "adaptive_turbo.h"
+#include "frame_pacer.h"
+#include "present_stats.h"
+#include "driver_registry.h"
+#include "pipeline_cache.h"
+#include "java_bridge.h"
+#include "native_trace.h"
+#include <time.h>
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <csignal>
+#include <cerrno>
 
 
+// Time of the last present on the rendering thread
 std::chrono::time_point<std::chrono::steady_clock, std::chrono::nanoseconds> _currentTimePoint;
 
+long _renderFrameTargetNs = 16666667;
+long _renderThreadCpuTimeNs = 0;
+
 extern "C"
 {
 JNIEXPORT jlong JNICALL
@@ -47,6 +63,7 @@ Java_org_ryujinx_android_NativeHelpers_releaseNativeWindow(
 }
 
 long createSurface(long native_surface, long instance) {
+    TRACE_SCOPE("createSurface");
     auto nativeWindow = (ANativeWindow *) native_surface;
     VkSurfaceKHR surface;
     auto vkInstance = (VkInstance) instance;
@@ -73,7 +90,7 @@ char *getStringPointer(
         jstring jS) {
     const char *cparam = env->GetStringUTFChars(jS, 0);
     auto len = env->GetStringUTFLength(jS);
-    char *s = new char[len];
+    char *s = new char[len + 1];
     strcpy(s, cparam);
     env->ReleaseStringUTFChars(jS, cparam);
 
@@ -98,13 +115,122 @@ jstring createStringFromStdString(
 
 
 }
+
+// steady_clock is CLOCK_MONOTONIC, the same clock Oboe timestamps use,
+// so frame pacing and audio timestamps can be compared directly.
+extern "C"
+long getMonotonicTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The audio renderer registers a provider returning when the next audio frame it is written will
+// be heard, on the getMonotonicTimeNs clock, or 0 if unknown. The presenter compares it against
+// its own present time, so A/V latency is measured on one clock.
+typedef long (*AudioPresentationTimeProvider)(void *context);
+
+std::mutex _audioClockMutex;
+AudioPresentationTimeProvider _audioPresentationTimeProvider = nullptr;
+void *_audioPresentationTimeContext = nullptr;
+
+extern "C"
+void setAudioPresentationTimeProvider(AudioPresentationTimeProvider provider, void *context) {
+    std::lock_guard<std::mutex> lock(_audioClockMutex);
+    _audioPresentationTimeProvider = provider;
+    _audioPresentationTimeContext = context;
+}
+
+// Only clears a provider registered with the same context, so a renderer shutting down doesn't
+// unregister the one that replaced it
+extern "C"
+void clearAudioPresentationTimeProvider(void *context) {
+    std::lock_guard<std::mutex> lock(_audioClockMutex);
+    if (_audioPresentationTimeContext != context)
+        return;
+
+    _audioPresentationTimeProvider = nullptr;
+    _audioPresentationTimeContext = nullptr;
+}
+
+// The lock is held across the call, so once clear returns the provider is no longer running
+extern "C"
+long getAudioPresentationTime() {
+    std::lock_guard<std::mutex> lock(_audioClockMutex);
+    return _audioPresentationTimeProvider != nullptr
+           ? _audioPresentationTimeProvider(_audioPresentationTimeContext)
+           : 0;
+}
+
 extern "C"
 void setRenderingThread() {
     auto currentId = pthread_self();
 
     _renderingThreadId = currentId;
 
-    _currentTimePoint = std::chrono::high_resolution_clock::now();
+    _currentTimePoint = std::chrono::steady_clock::now();
+
+    tuneThread(THREAD_ROLE_RENDER, gettid(), _renderFrameTargetNs);
+}
+
+// Frame budget of the cadence the game is actually presented at: the paced multiple of the
+// refresh period, else the guest rate the surface was matched to, else 60 fps.
+long getRenderFrameTargetNs() {
+    auto refreshPeriod = framePacerGetRefreshPeriod();
+    auto swapMultiple = framePacerGetSwapMultiple();
+    if (refreshPeriod > 0 && swapMultiple > 0)
+        return (long) (refreshPeriod * swapMultiple);
+
+    auto guestFrameRate = framePacerGetGuestFrameRate();
+    if (guestFrameRate > 0.0f)
+        return (long) (1000000000.0f / guestFrameRate);
+
+    return 16666667;
+}
+
+// Called by the audio renderer from its callback whenever the callback thread changes, that is
+// once per opened stream; the target is the duration of one callback
+extern "C"
+void setAudioCallbackThread(int tid, long targetDurationNs) {
+    tuneThread(THREAD_ROLE_AUDIO, tid, targetDurationNs);
+}
+
+// Called by the audio renderer at the end of every callback
+extern "C"
+void reportAudioCallbackDuration(long durationNs) {
+    reportThreadWorkDuration(THREAD_ROLE_AUDIO, durationNs);
+}
+
+long getThreadCpuTimeNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Called on the rendering thread after each present. The CPU share is the rendering
+// thread's own CPU time since the previous frame, so idle waits are not counted. The target
+// follows the pacer, so a 30 fps title is not held to a 60 fps budget.
+extern "C"
+void reportRenderFrameDuration(long durationNs) {
+    if (durationNs <= 0)
+        return;
+
+    auto cpuTime = getThreadCpuTimeNs();
+    auto cpuDuration = _renderThreadCpuTimeNs != 0
+                       ? std::min(cpuTime - _renderThreadCpuTimeNs, durationNs)
+                       : durationNs;
+    _renderThreadCpuTimeNs = cpuTime;
+
+    auto targetNs = getRenderFrameTargetNs();
+    if (targetNs != _renderFrameTargetNs) {
+        _renderFrameTargetNs = targetNs;
+        updateThreadTargetDuration(THREAD_ROLE_RENDER, targetNs);
+    }
+
+    reportThreadWorkDurations(THREAD_ROLE_RENDER, getMonotonicTimeNs() - durationNs, durationNs,
+                              cpuDuration);
+
+    // Judged on busy time, a frame that only waited on the swapchain does not need more clocks
+    onRenderFrameWorkDuration(cpuDuration, _renderFrameTargetNs);
 }
 extern "C"
 JNIEXPORT void JNICALL
@@ -112,16 +238,34 @@ Java_org_ryujinx_android_MainActivity_initVm(JNIEnv *env, jobject thiz) {
     JavaVM *vm = nullptr;
     auto success = env->GetJavaVM(&vm);
     _vm = vm;
-    _mainActivity = thiz;
-    _mainActivityClass = env->GetObjectClass(thiz);
+    // thiz is only valid for this call, keep global references for later callbacks. The activity
+    // is recreated on configuration changes, so drop the references to the previous one.
+    if (_mainActivity != nullptr)
+        env->DeleteGlobalRef(_mainActivity);
+    if (_mainActivityClass != nullptr)
+        env->DeleteGlobalRef(_mainActivityClass);
+    _mainActivity = env->NewGlobalRef(thiz);
+    auto mainActivityClass = env->GetObjectClass(thiz);
+    _mainActivityClass = (jclass) env->NewGlobalRef(mainActivityClass);
+    env->DeleteLocalRef(mainActivityClass);
+
+    javaBridgeInit(env, _mainActivityClass);
+
+    // Only installs lazy stubs, symbols are looked up when first called
+    InitVulkan();
 }
 
 bool isInitialOrientationFlipped = true;
 
+// Read by the renderer on each present, it then renders in the panel's native orientation
+// and hands the rotation to the swapchain instead of setCurrentTransform
+std::atomic<bool> _prerotationEnabled = false;
+
 extern "C"
 void setCurrentTransform(long native_window, int transform) {
     if (native_window == 0 || native_window == -1)
         return;
+    TRACE_SCOPE("setCurrentTransform");
     auto nativeWindow = (ANativeWindow *) native_window;
 
     auto nativeTransform = ANativeWindowTransform::ANATIVEWINDOW_TRANSFORM_IDENTITY;
@@ -169,34 +313,163 @@ void setCurrentTransform(long native_window, int transform) {
                           static_cast<int32_t>(nativeTransform));
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_setPrerotation(JNIEnv *env, jobject thiz, jboolean enable) {
+    _prerotationEnabled = enable;
+}
+
+extern "C"
+bool getPrerotation() {
+    return _prerotationEnabled;
+}
+
+extern "C"
+void onFramePresented(long native_window) {
+    if (native_window == 0 || native_window == -1)
+        return;
+
+    TRACE_SCOPE("onFramePresented");
+    _currentTimePoint = std::chrono::steady_clock::now();
+    samplePresentStats((ANativeWindow *) native_window);
+    framePacerOnFramePresented((ANativeWindow *) native_window);
+    TRACE_COUNTER("SwapMultiple", framePacerGetSwapMultiple());
+
+    // Percentiles sort the whole sample ring, only refresh them about once a second
+    static int framesSinceStats = 0;
+    if (++framesSinceStats >= 60) {
+        framesSinceStats = 0;
+
+        int64_t stats[PRESENT_STATS_COUNT];
+        getPresentStats(stats);
+        javaBridgePostEvent(NATIVE_EVENT_PRESENT_WAIT, stats[PRESENT_STATS_DEQUEUE_P95]);
+        javaBridgePostEvent(NATIVE_EVENT_GUEST_FRAME_RATE,
+                            (int64_t) (framePacerGetGuestFrameRate() * 1000.0f));
+        javaBridgePostEvent(NATIVE_EVENT_SWAP_MULTIPLE, framePacerGetSwapMultiple());
+
+        auto audioTime = getAudioPresentationTime();
+        if (audioTime != 0)
+            javaBridgePostEvent(NATIVE_EVENT_AUDIO_LATENCY,
+                                audioTime - _currentTimePoint.time_since_epoch().count());
+    }
+
+    javaBridgeFlush();
+}
+
+// Called instead of onFramePresented when the swapchain dropped the frame on an acquire
+// timeout. Nothing was queued, so only the events posted since the last frame are delivered.
+extern "C"
+void onFrameDropped(long native_window) {
+    TRACE_SCOPE("onFrameDropped");
+    javaBridgeFlush();
+}
+
+// Lets code outside this library, such as the audio renderer, report events to Java.
+// Can be called from any thread.
+extern "C"
+void postNativeEvent(int event, long value) {
+    if (event < 0 || event >= NATIVE_EVENT_COUNT)
+        return;
+
+    javaBridgePostEvent((NativeEvent) event, value);
+}
+
 extern "C"
 JNIEXPORT jlong JNICALL
 Java_org_ryujinx_android_NativeHelpers_loadDriver(JNIEnv *env, jobject thiz,
                                                   jstring native_lib_path,
                                                   jstring private_apps_path,
                                                   jstring driver_name) {
+    TRACE_SCOPE("loadDriver");
+    auto start = std::chrono::steady_clock::now();
+
     auto libPath = getStringPointer(env, native_lib_path);
     auto privateAppsPath = getStringPointer(env, private_apps_path);
     auto driverName = getStringPointer(env, driver_name);
 
-    auto handle = adrenotools_open_libvulkan(
-            RTLD_NOW,
-            ADRENOTOOLS_DRIVER_CUSTOM,
-            nullptr,
-            libPath,
-            privateAppsPath,
-            driverName,
-            nullptr,
-            nullptr
-    );
-
-    delete libPath;
-    delete privateAppsPath;
-    delete driverName;
+    auto driver = openDriver(libPath, privateAppsPath, driverName);
+    auto handle = driver != nullptr ? driver->handle : nullptr;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    __android_log_print(ANDROID_LOG_INFO, "RyujinxVulkan", "Loading driver %s took %lld us, %d symbols resolved so far",
+                        driverName, static_cast<long long>(elapsed), GetVulkanResolvedSymbolCount());
+
+    delete[] libPath;
+    delete[] privateAppsPath;
+    delete[] driverName;
 
     return (jlong) handle;
 }
 
+// Device entry points for the managed Vulkan backend, resolved with vkGetDeviceProcAddr of the
+// active driver so draw time calls skip the loader trampolines
+extern "C"
+void setVulkanDriver(long driver_handle) {
+    SetVulkanDriver((void *) driver_handle);
+
+    auto driver = findDriver((void *) driver_handle);
+    setPipelineCacheDriverName(driver != nullptr ? driver->driverName.c_str() : nullptr);
+}
+
+extern "C"
+bool loadPipelineCache(const uint8_t *uuid, const void **data, size_t *size) {
+    return pipelineCacheLoad(uuid, data, size);
+}
+
+extern "C"
+void attachPipelineCache(long device, long cache) {
+    pipelineCacheAttach((VkDevice) device, (VkPipelineCache) cache);
+}
+
+extern "C"
+void detachPipelineCache() {
+    pipelineCacheDetach();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_setPipelineCacheDirectory(JNIEnv *env, jobject thiz,
+                                                                 jstring path) {
+    auto cachePath = getStringPointer(env, path);
+    setPipelineCacheDirectory(cachePath);
+    delete[] cachePath;
+}
+
+extern "C"
+void *getVulkanDeviceFunction(long device, const char *name) {
+    return (void *) GetVulkanDeviceFunction((VkDevice) device, name);
+}
+
+extern "C"
+void releaseVulkanDevice(long device) {
+    ReleaseVulkanDevice((VkDevice) device);
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_org_ryujinx_android_NativeHelpers_getDriverExtensions(JNIEnv *env, jobject thiz,
+                                                           jlong driver_handle) {
+    auto driver = findDriver((void *) driver_handle);
+    auto count = driver != nullptr ? (jsize) driver->extensions.size() : 0;
+
+    auto array = env->NewObjectArray(count, env->FindClass("java/lang/String"), nullptr);
+    for (jsize i = 0; i < count; i++) {
+        auto name = env->NewStringUTF(driver->extensions[i].c_str());
+        env->SetObjectArrayElement(array, i, name);
+        env->DeleteLocalRef(name);
+    }
+    return array;
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_org_ryujinx_android_NativeHelpers_getDriverDeviceName(JNIEnv *env, jobject thiz,
+                                                           jlong driver_handle) {
+    auto driver = findDriver((void *) driver_handle);
+    return env->NewStringUTF(driver != nullptr ? driver->deviceName.c_str() : "");
+}
+
 extern "C"
 void debug_break(int code) {
     if (code >= 3)
@@ -209,6 +482,12 @@ Java_org_ryujinx_android_NativeHelpers_setTurboMode(JNIEnv *env, jobject thiz, j
     adrenotools_set_turbo(enable);
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_setAdaptiveTurbo(JNIEnv *env, jobject thiz, jboolean enable) {
+    setAdaptiveTurboEnabled(enable);
+}
+
 extern "C"
 JNIEXPORT jint JNICALL
 Java_org_ryujinx_android_NativeHelpers_getMaxSwapInterval(JNIEnv *env, jobject thiz,
@@ -231,11 +510,144 @@ extern "C"
 JNIEXPORT jint JNICALL
 Java_org_ryujinx_android_NativeHelpers_setSwapInterval(JNIEnv *env, jobject thiz,
                                                        jlong native_window, jint swap_interval) {
+    TRACE_SCOPE("setSwapInterval");
     auto nativeWindow = (ANativeWindow *) native_window;
 
     return nativeWindow->setSwapInterval(nativeWindow, swap_interval);
 }
 
+// Requested swapchain image count, 0 keeps the renderer default. The Vulkan swapchain sizes the
+// BufferQueue itself, so this is picked up on the next swapchain recreation rather than applied
+// with NATIVE_WINDOW_SET_BUFFER_COUNT, which would free the buffers of the live swapchain.
+std::atomic_int _swapchainBufferCount = 0;
+// Dequeue timeout in ns, -1 blocks until a buffer is free
+std::atomic<long> _dequeueTimeoutNs = -1;
+
+extern "C"
+int getSwapchainBufferCount() {
+    return _swapchainBufferCount.load(std::memory_order_relaxed);
+}
+
+extern "C"
+long getDequeueTimeout() {
+    return _dequeueTimeoutNs.load(std::memory_order_relaxed);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_org_ryujinx_android_NativeHelpers_setBufferCount(JNIEnv *env, jobject thiz,
+                                                      jlong native_window, jint buffer_count) {
+    if (buffer_count < 0)
+        return -EINVAL;
+
+    _swapchainBufferCount.store(buffer_count, std::memory_order_relaxed);
+    return 0;
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_org_ryujinx_android_NativeHelpers_setDequeueTimeout(JNIEnv *env, jobject thiz,
+                                                         jlong native_window, jlong timeout_ns) {
+    auto timeout = timeout_ns < 0 ? -1 : timeout_ns;
+    _dequeueTimeoutNs.store(timeout, std::memory_order_relaxed);
+
+    if (native_window == 0 || native_window == -1)
+        return 0;
+    auto nativeWindow = (ANativeWindow *) native_window;
+
+    // The swapchain forwards its acquire timeout here too, this covers the frames until it does
+    return nativeWindow->perform(nativeWindow, NATIVE_WINDOW_SET_DEQUEUE_TIMEOUT,
+                                 static_cast<int64_t>(timeout));
+}
+
+// Shared present mode lets the compositor latch the image the GPU is drawing into, removing the
+// BufferQueue depth from present latency at the cost of possible tearing. The swapchain switches
+// to a single VK_KHR_shared_presentable_image in continuous refresh mode on its next recreation
+// when the driver supports it, and reports back whether the swapchain it created uses it.
+std::atomic_bool _sharedPresentRequested = false;
+std::atomic_bool _sharedPresentActive = false;
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_setSharedBufferMode(JNIEnv *env, jobject thiz,
+                                                           jboolean enable) {
+    _sharedPresentRequested = enable;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_org_ryujinx_android_NativeHelpers_isSharedBufferModeActive(JNIEnv *env, jobject thiz) {
+    return _sharedPresentActive;
+}
+
+extern "C"
+bool getSharedPresentRequested() {
+    return _sharedPresentRequested;
+}
+
+extern "C"
+void setSharedPresentActive(bool active) {
+    _sharedPresentActive = active;
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_org_ryujinx_android_NativeHelpers_setFrameRate(JNIEnv *env, jobject thiz,
+                                                    jlong native_window, jfloat frame_rate) {
+    auto nativeWindow = (ANativeWindow *) native_window;
+
+    return ANativeWindow_setFrameRate(nativeWindow, frame_rate,
+                                      ANATIVEWINDOW_FRAME_RATE_COMPATIBILITY_DEFAULT);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_setFrameRateMatching(JNIEnv *env, jobject thiz,
+                                                            jboolean enable) {
+    framePacerSetFrameRateMatching(enable);
+}
+
+extern "C"
+JNIEXPORT jfloat JNICALL
+Java_org_ryujinx_android_NativeHelpers_getGuestFrameRate(JNIEnv *env, jobject thiz) {
+    return framePacerGetGuestFrameRate();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_setFramePacing(JNIEnv *env, jobject thiz, jboolean enable) {
+    framePacerSetEnabled(enable);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_org_ryujinx_android_NativeHelpers_getRefreshPeriod(JNIEnv *env, jobject thiz) {
+    return framePacerGetRefreshPeriod();
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_org_ryujinx_android_NativeHelpers_getSwapMultiple(JNIEnv *env, jobject thiz) {
+    return framePacerGetSwapMultiple();
+}
+
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_org_ryujinx_android_NativeHelpers_getPresentStats(JNIEnv *env, jobject thiz) {
+    int64_t stats[PRESENT_STATS_COUNT];
+    getPresentStats(stats);
+
+    auto array = env->NewLongArray(PRESENT_STATS_COUNT);
+    env->SetLongArrayRegion(array, 0, PRESENT_STATS_COUNT, reinterpret_cast<const jlong *>(stats));
+    return array;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_org_ryujinx_android_NativeHelpers_resetPresentStats(JNIEnv *env, jobject thiz) {
+    resetPresentStats();
+}
+
 extern "C"
 JNIEXPORT jstring JNICALL
 Java_org_ryujinx_android_NativeHelpers_getStringJava(JNIEnv *env, jobject thiz, jlong ptr) {
@@ -0,0 +1,268 @@
+#include "thread_tuning.h"
+#include <android/log.h>
+#include <dlfcn.h>
+#include <sched.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+#define TUNING_LOG(...) __android_log_print(ANDROID_LOG_INFO, "RyujinxThreadTuning", __VA_ARGS__)
+
+namespace {
+
+// APerformanceHint is API 33, minSdk is 30, so it is resolved at runtime
+struct APerformanceHintManager;
+struct APerformanceHintSession;
+struct AWorkDuration;
+
+typedef APerformanceHintManager *(*PFN_getManager)();
+typedef APerformanceHintSession *(*PFN_createSession)(APerformanceHintManager *, const int32_t *,
+                                                       size_t, int64_t);
+typedef int (*PFN_updateTargetWorkDuration)(APerformanceHintSession *, int64_t);
+typedef int (*PFN_reportActualWorkDuration)(APerformanceHintSession *, int64_t);
+typedef void (*PFN_closeSession)(APerformanceHintSession *);
+typedef AWorkDuration *(*PFN_workDurationCreate)();
+typedef void (*PFN_workDurationSetNanos)(AWorkDuration *, int64_t);
+typedef int (*PFN_reportActualWorkDuration2)(APerformanceHintSession *, AWorkDuration *);
+
+struct PerformanceHintApi {
+    bool loaded = false;
+    APerformanceHintManager *manager = nullptr;
+    PFN_createSession createSession = nullptr;
+    PFN_updateTargetWorkDuration updateTargetWorkDuration = nullptr;
+    PFN_reportActualWorkDuration reportActualWorkDuration = nullptr;
+    PFN_closeSession closeSession = nullptr;
+
+    // API 35
+    PFN_workDurationCreate workDurationCreate = nullptr;
+    PFN_workDurationSetNanos setWorkPeriodStart = nullptr;
+    PFN_workDurationSetNanos setTotalDuration = nullptr;
+    PFN_workDurationSetNanos setCpuDuration = nullptr;
+    PFN_reportActualWorkDuration2 reportActualWorkDuration2 = nullptr;
+};
+
+// Nice value of Process.THREAD_PRIORITY_URGENT_DISPLAY, the lowest an app may request
+constexpr int RenderThreadNice = -8;
+constexpr int AudioThreadFifoPriority = 2;
+
+std::mutex _tuningMutex;
+PerformanceHintApi _hintApi;
+// Guards the session and work duration of a role, so a report never uses a session
+// that tuneThread or releaseThreadTuning is closing. Per role so the render and audio
+// threads do not contend with each other.
+std::mutex _sessionMutexes[THREAD_ROLE_COUNT];
+APerformanceHintSession *_sessions[THREAD_ROLE_COUNT] = {};
+AWorkDuration *_workDurations[THREAD_ROLE_COUNT] = {};
+
+PerformanceHintApi &getHintApi() {
+    if (_hintApi.loaded)
+        return _hintApi;
+
+    _hintApi.loaded = true;
+    auto lib = dlopen("libandroid.so", RTLD_NOW | RTLD_NOLOAD);
+    if (lib == nullptr)
+        lib = dlopen("libandroid.so", RTLD_NOW);
+    if (lib == nullptr)
+        return _hintApi;
+
+    auto getManager = reinterpret_cast<PFN_getManager>(dlsym(lib, "APerformanceHint_getManager"));
+    _hintApi.createSession = reinterpret_cast<PFN_createSession>(
+            dlsym(lib, "APerformanceHint_createSession"));
+    _hintApi.updateTargetWorkDuration = reinterpret_cast<PFN_updateTargetWorkDuration>(
+            dlsym(lib, "APerformanceHint_updateTargetWorkDuration"));
+    _hintApi.reportActualWorkDuration = reinterpret_cast<PFN_reportActualWorkDuration>(
+            dlsym(lib, "APerformanceHint_reportActualWorkDuration"));
+    _hintApi.closeSession = reinterpret_cast<PFN_closeSession>(
+            dlsym(lib, "APerformanceHint_closeSession"));
+
+    _hintApi.workDurationCreate = reinterpret_cast<PFN_workDurationCreate>(
+            dlsym(lib, "AWorkDuration_create"));
+    _hintApi.setWorkPeriodStart = reinterpret_cast<PFN_workDurationSetNanos>(
+            dlsym(lib, "AWorkDuration_setWorkPeriodStartTimestampNanos"));
+    _hintApi.setTotalDuration = reinterpret_cast<PFN_workDurationSetNanos>(
+            dlsym(lib, "AWorkDuration_setActualTotalDurationNanos"));
+    _hintApi.setCpuDuration = reinterpret_cast<PFN_workDurationSetNanos>(
+            dlsym(lib, "AWorkDuration_setActualCpuDurationNanos"));
+    _hintApi.reportActualWorkDuration2 = reinterpret_cast<PFN_reportActualWorkDuration2>(
+            dlsym(lib, "APerformanceHint_reportActualWorkDuration2"));
+
+    if (getManager != nullptr && _hintApi.createSession != nullptr &&
+        _hintApi.reportActualWorkDuration != nullptr && _hintApi.closeSession != nullptr)
+        _hintApi.manager = getManager();
+
+    return _hintApi;
+}
+
+long readMaxFrequency(int cpu) {
+    std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                       "/cpufreq/cpuinfo_max_freq");
+    long frequency = 0;
+    file >> frequency;
+    return frequency;
+}
+
+// Splits the cores into the slowest cluster and everything else.
+// Both sets are empty on homogeneous or unreadable topologies.
+void getCoreClusters(cpu_set_t &littleCores, cpu_set_t &bigCores, bool &heterogeneous) {
+    static std::once_flag once;
+    static cpu_set_t little, big;
+    static bool valid = false;
+
+    std::call_once(once, []() {
+        CPU_ZERO(&little);
+        CPU_ZERO(&big);
+
+        auto count = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+        std::vector<long> frequencies;
+        for (int cpu = 0; cpu < count && cpu < CPU_SETSIZE; cpu++)
+            frequencies.push_back(readMaxFrequency(cpu));
+
+        auto [minIt, maxIt] = std::minmax_element(frequencies.begin(), frequencies.end());
+        if (frequencies.empty() || *minIt <= 0 || *minIt == *maxIt)
+            return;
+
+        for (int cpu = 0; cpu < static_cast<int>(frequencies.size()); cpu++) {
+            if (frequencies[cpu] == *minIt)
+                CPU_SET(cpu, &little);
+            else
+                CPU_SET(cpu, &big);
+        }
+        valid = true;
+    });
+
+    littleCores = little;
+    bigCores = big;
+    heterogeneous = valid;
+}
+
+void setAffinity(ThreadRole role, pid_t tid) {
+    cpu_set_t littleCores, bigCores;
+    bool heterogeneous;
+    getCoreClusters(littleCores, bigCores, heterogeneous);
+    if (!heterogeneous)
+        return;
+
+    // The render thread must stay off the little cluster. The audio callback is short and
+    // periodic, so it lives on the little cores and never competes with the render thread.
+    auto &cores = role == THREAD_ROLE_RENDER ? bigCores : littleCores;
+    if (sched_setaffinity(tid, sizeof(cores), &cores) != 0)
+        TUNING_LOG("sched_setaffinity(%d) failed: %s", tid, strerror(errno));
+}
+
+void setPriority(ThreadRole role, pid_t tid) {
+    if (role == THREAD_ROLE_AUDIO) {
+        // AAudio usually already runs the callback as SCHED_FIFO
+        if (sched_getscheduler(tid) == SCHED_FIFO)
+            return;
+
+        sched_param param = {};
+        param.sched_priority = AudioThreadFifoPriority;
+        if (sched_setscheduler(tid, SCHED_FIFO, &param) == 0)
+            return;
+    }
+
+    // SCHED_FIFO on a thread that can run for a whole frame would starve the rest of the
+    // app, so the render thread (and audio if FIFO was refused) only gets a nice boost
+    if (setpriority(PRIO_PROCESS, tid, RenderThreadNice) != 0)
+        TUNING_LOG("setpriority(%d) failed: %s", tid, strerror(errno));
+}
+
+}
+
+bool tuneThread(ThreadRole role, pid_t tid, int64_t targetDurationNs) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT || tid <= 0)
+        return false;
+
+    setAffinity(role, tid);
+    setPriority(role, tid);
+
+    std::lock_guard<std::mutex> lock(_tuningMutex);
+
+    auto &api = getHintApi();
+    if (api.manager == nullptr)
+        return false;
+
+    int32_t tids[] = {static_cast<int32_t>(tid)};
+    auto session = api.createSession(api.manager, tids, 1, targetDurationNs);
+
+    std::lock_guard<std::mutex> sessionLock(_sessionMutexes[role]);
+    if (_sessions[role] != nullptr)
+        api.closeSession(_sessions[role]);
+    _sessions[role] = session;
+
+    return session != nullptr;
+}
+
+void reportThreadWorkDuration(ThreadRole role, int64_t actualDurationNs) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT || actualDurationNs <= 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_sessionMutexes[role]);
+
+    auto session = _sessions[role];
+    if (session != nullptr)
+        _hintApi.reportActualWorkDuration(session, actualDurationNs);
+}
+
+void reportThreadWorkDurations(ThreadRole role, int64_t startTimeNs, int64_t totalDurationNs,
+                               int64_t cpuDurationNs) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT || totalDurationNs <= 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_sessionMutexes[role]);
+
+    auto session = _sessions[role];
+    if (session == nullptr)
+        return;
+
+    auto &api = _hintApi;
+    if (api.reportActualWorkDuration2 == nullptr || api.workDurationCreate == nullptr ||
+        api.setWorkPeriodStart == nullptr || api.setTotalDuration == nullptr ||
+        api.setCpuDuration == nullptr) {
+        api.reportActualWorkDuration(session, totalDurationNs);
+        return;
+    }
+
+    auto &workDuration = _workDurations[role];
+    if (workDuration == nullptr)
+        workDuration = api.workDurationCreate();
+    if (workDuration == nullptr) {
+        api.reportActualWorkDuration(session, totalDurationNs);
+        return;
+    }
+
+    // The API rejects a zero CPU duration, so attribute the whole frame to the CPU if unknown
+    api.setWorkPeriodStart(workDuration, startTimeNs);
+    api.setTotalDuration(workDuration, totalDurationNs);
+    api.setCpuDuration(workDuration, cpuDurationNs > 0 ? cpuDurationNs : totalDurationNs);
+    api.reportActualWorkDuration2(session, workDuration);
+}
+
+void updateThreadTargetDuration(ThreadRole role, int64_t targetDurationNs) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT || targetDurationNs <= 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_sessionMutexes[role]);
+
+    auto session = _sessions[role];
+    if (session != nullptr && _hintApi.updateTargetWorkDuration != nullptr)
+        _hintApi.updateTargetWorkDuration(session, targetDurationNs);
+}
+
+void releaseThreadTuning(ThreadRole role) {
+    if (role < 0 || role >= THREAD_ROLE_COUNT)
+        return;
+
+    std::lock_guard<std::mutex> lock(_sessionMutexes[role]);
+
+    auto session = _sessions[role];
+    _sessions[role] = nullptr;
+    if (session != nullptr)
+        _hintApi.closeSession(session);
+}
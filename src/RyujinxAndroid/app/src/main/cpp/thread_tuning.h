@@ -0,0 +1,29 @@
+#ifndef RYUJINXNATIVE_THREAD_TUNING_H
+#define RYUJINXNATIVE_THREAD_TUNING_H
+
+#include <sys/types.h>
+#include <cstdint>
+
+enum ThreadRole {
+    THREAD_ROLE_RENDER = 0,
+    THREAD_ROLE_AUDIO = 1,
+    THREAD_ROLE_COUNT
+};
+
+// Pins the thread to the cores suited to its role, raises its priority and opens a
+// performance hint session with the given per-frame target. Safe to call again for a new tid.
+bool tuneThread(ThreadRole role, pid_t tid, int64_t targetDurationNs);
+
+// Reports how long the last frame of work took. No-op without a hint session.
+void reportThreadWorkDuration(ThreadRole role, int64_t actualDurationNs);
+
+// Reports the CPU share of the last frame alongside its total where the platform supports
+// it (API 35), otherwise only the total.
+void reportThreadWorkDurations(ThreadRole role, int64_t startTimeNs, int64_t totalDurationNs,
+                               int64_t cpuDurationNs);
+
+void updateThreadTargetDuration(ThreadRole role, int64_t targetDurationNs);
+
+void releaseThreadTuning(ThreadRole role);
+
+#endif //RYUJINXNATIVE_THREAD_TUNING_H
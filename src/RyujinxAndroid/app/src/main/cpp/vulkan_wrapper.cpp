@@ -13,206 +13,270 @@
 // limitations under the License.
 // This file is generated.
 #include "vulkan_wrapper.h"
+#include "native_trace.h"
 #include <dlfcn.h>
+#include <android/log.h>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+// Lazy resolution
+// Every entry point starts out as a stub that looks the real symbol up on its first call,
+// patches the global pointer and forwards the call, so startup does not pay for hundreds of
+// dlsym lookups of functions that may never be used.
+namespace {
+
+void* s_libvulkan = nullptr;
+std::atomic<int> s_lazyResolvedCount{0};
+
+void* ResolveVulkanSymbol(const char* name) {
+    // First calls resolve in place, so a slow lookup shows up as a hitch in the caller
+    TRACE_SCOPE(name);
+    auto symbol = dlsym(s_libvulkan, name);
+    if (!symbol)
+        __android_log_print(ANDROID_LOG_ERROR, "RyujinxVulkan", "Missing Vulkan entry point %s", name);
+    s_lazyResolvedCount.fetch_add(1, std::memory_order_relaxed);
+    return symbol;
+}
+
+template<typename PFN, PFN* Slot, const char* Name>
+struct LazyVulkanSymbol;
+
+template<typename R, typename... Args, R (VKAPI_PTR** Slot)(Args...), const char* Name>
+struct LazyVulkanSymbol<R (VKAPI_PTR*)(Args...), Slot, Name> {
+    static R VKAPI_PTR Stub(Args... args) {
+        auto function = reinterpret_cast<R (VKAPI_PTR*)(Args...)>(ResolveVulkanSymbol(Name));
+        if (!function) {
+            if constexpr (std::is_same_v<R, VkResult>)
+                return VK_ERROR_INITIALIZATION_FAILED;
+            else
+                return R();
+        }
+
+        // Racing first calls store the same value
+        __atomic_store_n(Slot, function, __ATOMIC_RELEASE);
+        return function(args...);
+    }
+};
+
+}
+
+#define VK_LAZY(name) \
+    do { \
+        static constexpr char symbolName[] = #name; \
+        name = &LazyVulkanSymbol<PFN_##name, &name, symbolName>::Stub; \
+    } while (0)
 
 int InitVulkan(void) {
-    void* libvulkan = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
-    if (!libvulkan)
+    TRACE_SCOPE("InitVulkan");
+    auto start = std::chrono::steady_clock::now();
+
+    if (!s_libvulkan)
+        s_libvulkan = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+    if (!s_libvulkan)
         return 0;
 
-    // Vulkan supported, set function addresses
-    vkCreateInstance = reinterpret_cast<PFN_vkCreateInstance>(dlsym(libvulkan, "vkCreateInstance"));
-    vkDestroyInstance = reinterpret_cast<PFN_vkDestroyInstance>(dlsym(libvulkan, "vkDestroyInstance"));
-    vkEnumeratePhysicalDevices = reinterpret_cast<PFN_vkEnumeratePhysicalDevices>(dlsym(libvulkan, "vkEnumeratePhysicalDevices"));
-    vkGetPhysicalDeviceFeatures = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures>(dlsym(libvulkan, "vkGetPhysicalDeviceFeatures"));
-    vkGetPhysicalDeviceFormatProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceFormatProperties>(dlsym(libvulkan, "vkGetPhysicalDeviceFormatProperties"));
-    vkGetPhysicalDeviceImageFormatProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceImageFormatProperties>(dlsym(libvulkan, "vkGetPhysicalDeviceImageFormatProperties"));
-    vkGetPhysicalDeviceProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties>(dlsym(libvulkan, "vkGetPhysicalDeviceProperties"));
-    vkGetPhysicalDeviceQueueFamilyProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceQueueFamilyProperties>(dlsym(libvulkan, "vkGetPhysicalDeviceQueueFamilyProperties"));
-    vkGetPhysicalDeviceMemoryProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties>(dlsym(libvulkan, "vkGetPhysicalDeviceMemoryProperties"));
-    vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>(dlsym(libvulkan, "vkGetInstanceProcAddr"));
-    vkGetDeviceProcAddr = reinterpret_cast<PFN_vkGetDeviceProcAddr>(dlsym(libvulkan, "vkGetDeviceProcAddr"));
-    vkCreateDevice = reinterpret_cast<PFN_vkCreateDevice>(dlsym(libvulkan, "vkCreateDevice"));
-    vkDestroyDevice = reinterpret_cast<PFN_vkDestroyDevice>(dlsym(libvulkan, "vkDestroyDevice"));
-    vkEnumerateInstanceExtensionProperties = reinterpret_cast<PFN_vkEnumerateInstanceExtensionProperties>(dlsym(libvulkan, "vkEnumerateInstanceExtensionProperties"));
-    vkEnumerateDeviceExtensionProperties = reinterpret_cast<PFN_vkEnumerateDeviceExtensionProperties>(dlsym(libvulkan, "vkEnumerateDeviceExtensionProperties"));
-    vkEnumerateInstanceLayerProperties = reinterpret_cast<PFN_vkEnumerateInstanceLayerProperties>(dlsym(libvulkan, "vkEnumerateInstanceLayerProperties"));
-    vkEnumerateDeviceLayerProperties = reinterpret_cast<PFN_vkEnumerateDeviceLayerProperties>(dlsym(libvulkan, "vkEnumerateDeviceLayerProperties"));
-    vkGetDeviceQueue = reinterpret_cast<PFN_vkGetDeviceQueue>(dlsym(libvulkan, "vkGetDeviceQueue"));
-    vkQueueSubmit = reinterpret_cast<PFN_vkQueueSubmit>(dlsym(libvulkan, "vkQueueSubmit"));
-    vkQueueWaitIdle = reinterpret_cast<PFN_vkQueueWaitIdle>(dlsym(libvulkan, "vkQueueWaitIdle"));
-    vkDeviceWaitIdle = reinterpret_cast<PFN_vkDeviceWaitIdle>(dlsym(libvulkan, "vkDeviceWaitIdle"));
-    vkAllocateMemory = reinterpret_cast<PFN_vkAllocateMemory>(dlsym(libvulkan, "vkAllocateMemory"));
-    vkFreeMemory = reinterpret_cast<PFN_vkFreeMemory>(dlsym(libvulkan, "vkFreeMemory"));
-    vkMapMemory = reinterpret_cast<PFN_vkMapMemory>(dlsym(libvulkan, "vkMapMemory"));
-    vkUnmapMemory = reinterpret_cast<PFN_vkUnmapMemory>(dlsym(libvulkan, "vkUnmapMemory"));
-    vkFlushMappedMemoryRanges = reinterpret_cast<PFN_vkFlushMappedMemoryRanges>(dlsym(libvulkan, "vkFlushMappedMemoryRanges"));
-    vkInvalidateMappedMemoryRanges = reinterpret_cast<PFN_vkInvalidateMappedMemoryRanges>(dlsym(libvulkan, "vkInvalidateMappedMemoryRanges"));
-    vkGetDeviceMemoryCommitment = reinterpret_cast<PFN_vkGetDeviceMemoryCommitment>(dlsym(libvulkan, "vkGetDeviceMemoryCommitment"));
-    vkBindBufferMemory = reinterpret_cast<PFN_vkBindBufferMemory>(dlsym(libvulkan, "vkBindBufferMemory"));
-    vkBindImageMemory = reinterpret_cast<PFN_vkBindImageMemory>(dlsym(libvulkan, "vkBindImageMemory"));
-    vkGetBufferMemoryRequirements = reinterpret_cast<PFN_vkGetBufferMemoryRequirements>(dlsym(libvulkan, "vkGetBufferMemoryRequirements"));
-    vkGetImageMemoryRequirements = reinterpret_cast<PFN_vkGetImageMemoryRequirements>(dlsym(libvulkan, "vkGetImageMemoryRequirements"));
-    vkGetImageSparseMemoryRequirements = reinterpret_cast<PFN_vkGetImageSparseMemoryRequirements>(dlsym(libvulkan, "vkGetImageSparseMemoryRequirements"));
-    vkGetPhysicalDeviceSparseImageFormatProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceSparseImageFormatProperties>(dlsym(libvulkan, "vkGetPhysicalDeviceSparseImageFormatProperties"));
-    vkQueueBindSparse = reinterpret_cast<PFN_vkQueueBindSparse>(dlsym(libvulkan, "vkQueueBindSparse"));
-    vkCreateFence = reinterpret_cast<PFN_vkCreateFence>(dlsym(libvulkan, "vkCreateFence"));
-    vkDestroyFence = reinterpret_cast<PFN_vkDestroyFence>(dlsym(libvulkan, "vkDestroyFence"));
-    vkResetFences = reinterpret_cast<PFN_vkResetFences>(dlsym(libvulkan, "vkResetFences"));
-    vkGetFenceStatus = reinterpret_cast<PFN_vkGetFenceStatus>(dlsym(libvulkan, "vkGetFenceStatus"));
-    vkWaitForFences = reinterpret_cast<PFN_vkWaitForFences>(dlsym(libvulkan, "vkWaitForFences"));
-    vkCreateSemaphore = reinterpret_cast<PFN_vkCreateSemaphore>(dlsym(libvulkan, "vkCreateSemaphore"));
-    vkDestroySemaphore = reinterpret_cast<PFN_vkDestroySemaphore>(dlsym(libvulkan, "vkDestroySemaphore"));
-    vkCreateEvent = reinterpret_cast<PFN_vkCreateEvent>(dlsym(libvulkan, "vkCreateEvent"));
-    vkDestroyEvent = reinterpret_cast<PFN_vkDestroyEvent>(dlsym(libvulkan, "vkDestroyEvent"));
-    vkGetEventStatus = reinterpret_cast<PFN_vkGetEventStatus>(dlsym(libvulkan, "vkGetEventStatus"));
-    vkSetEvent = reinterpret_cast<PFN_vkSetEvent>(dlsym(libvulkan, "vkSetEvent"));
-    vkResetEvent = reinterpret_cast<PFN_vkResetEvent>(dlsym(libvulkan, "vkResetEvent"));
-    vkCreateQueryPool = reinterpret_cast<PFN_vkCreateQueryPool>(dlsym(libvulkan, "vkCreateQueryPool"));
-    vkDestroyQueryPool = reinterpret_cast<PFN_vkDestroyQueryPool>(dlsym(libvulkan, "vkDestroyQueryPool"));
-    vkGetQueryPoolResults = reinterpret_cast<PFN_vkGetQueryPoolResults>(dlsym(libvulkan, "vkGetQueryPoolResults"));
-    vkCreateBuffer = reinterpret_cast<PFN_vkCreateBuffer>(dlsym(libvulkan, "vkCreateBuffer"));
-    vkDestroyBuffer = reinterpret_cast<PFN_vkDestroyBuffer>(dlsym(libvulkan, "vkDestroyBuffer"));
-    vkCreateBufferView = reinterpret_cast<PFN_vkCreateBufferView>(dlsym(libvulkan, "vkCreateBufferView"));
-    vkDestroyBufferView = reinterpret_cast<PFN_vkDestroyBufferView>(dlsym(libvulkan, "vkDestroyBufferView"));
-    vkCreateImage = reinterpret_cast<PFN_vkCreateImage>(dlsym(libvulkan, "vkCreateImage"));
-    vkDestroyImage = reinterpret_cast<PFN_vkDestroyImage>(dlsym(libvulkan, "vkDestroyImage"));
-    vkGetImageSubresourceLayout = reinterpret_cast<PFN_vkGetImageSubresourceLayout>(dlsym(libvulkan, "vkGetImageSubresourceLayout"));
-    vkCreateImageView = reinterpret_cast<PFN_vkCreateImageView>(dlsym(libvulkan, "vkCreateImageView"));
-    vkDestroyImageView = reinterpret_cast<PFN_vkDestroyImageView>(dlsym(libvulkan, "vkDestroyImageView"));
-    vkCreateShaderModule = reinterpret_cast<PFN_vkCreateShaderModule>(dlsym(libvulkan, "vkCreateShaderModule"));
-    vkDestroyShaderModule = reinterpret_cast<PFN_vkDestroyShaderModule>(dlsym(libvulkan, "vkDestroyShaderModule"));
-    vkCreatePipelineCache = reinterpret_cast<PFN_vkCreatePipelineCache>(dlsym(libvulkan, "vkCreatePipelineCache"));
-    vkDestroyPipelineCache = reinterpret_cast<PFN_vkDestroyPipelineCache>(dlsym(libvulkan, "vkDestroyPipelineCache"));
-    vkGetPipelineCacheData = reinterpret_cast<PFN_vkGetPipelineCacheData>(dlsym(libvulkan, "vkGetPipelineCacheData"));
-    vkMergePipelineCaches = reinterpret_cast<PFN_vkMergePipelineCaches>(dlsym(libvulkan, "vkMergePipelineCaches"));
-    vkCreateGraphicsPipelines = reinterpret_cast<PFN_vkCreateGraphicsPipelines>(dlsym(libvulkan, "vkCreateGraphicsPipelines"));
-    vkCreateComputePipelines = reinterpret_cast<PFN_vkCreateComputePipelines>(dlsym(libvulkan, "vkCreateComputePipelines"));
-    vkDestroyPipeline = reinterpret_cast<PFN_vkDestroyPipeline>(dlsym(libvulkan, "vkDestroyPipeline"));
-    vkCreatePipelineLayout = reinterpret_cast<PFN_vkCreatePipelineLayout>(dlsym(libvulkan, "vkCreatePipelineLayout"));
-    vkDestroyPipelineLayout = reinterpret_cast<PFN_vkDestroyPipelineLayout>(dlsym(libvulkan, "vkDestroyPipelineLayout"));
-    vkCreateSampler = reinterpret_cast<PFN_vkCreateSampler>(dlsym(libvulkan, "vkCreateSampler"));
-    vkDestroySampler = reinterpret_cast<PFN_vkDestroySampler>(dlsym(libvulkan, "vkDestroySampler"));
-    vkCreateDescriptorSetLayout = reinterpret_cast<PFN_vkCreateDescriptorSetLayout>(dlsym(libvulkan, "vkCreateDescriptorSetLayout"));
-    vkDestroyDescriptorSetLayout = reinterpret_cast<PFN_vkDestroyDescriptorSetLayout>(dlsym(libvulkan, "vkDestroyDescriptorSetLayout"));
-    vkCreateDescriptorPool = reinterpret_cast<PFN_vkCreateDescriptorPool>(dlsym(libvulkan, "vkCreateDescriptorPool"));
-    vkDestroyDescriptorPool = reinterpret_cast<PFN_vkDestroyDescriptorPool>(dlsym(libvulkan, "vkDestroyDescriptorPool"));
-    vkResetDescriptorPool = reinterpret_cast<PFN_vkResetDescriptorPool>(dlsym(libvulkan, "vkResetDescriptorPool"));
-    vkAllocateDescriptorSets = reinterpret_cast<PFN_vkAllocateDescriptorSets>(dlsym(libvulkan, "vkAllocateDescriptorSets"));
-    vkFreeDescriptorSets = reinterpret_cast<PFN_vkFreeDescriptorSets>(dlsym(libvulkan, "vkFreeDescriptorSets"));
-    vkUpdateDescriptorSets = reinterpret_cast<PFN_vkUpdateDescriptorSets>(dlsym(libvulkan, "vkUpdateDescriptorSets"));
-    vkCreateFramebuffer = reinterpret_cast<PFN_vkCreateFramebuffer>(dlsym(libvulkan, "vkCreateFramebuffer"));
-    vkDestroyFramebuffer = reinterpret_cast<PFN_vkDestroyFramebuffer>(dlsym(libvulkan, "vkDestroyFramebuffer"));
-    vkCreateRenderPass = reinterpret_cast<PFN_vkCreateRenderPass>(dlsym(libvulkan, "vkCreateRenderPass"));
-    vkDestroyRenderPass = reinterpret_cast<PFN_vkDestroyRenderPass>(dlsym(libvulkan, "vkDestroyRenderPass"));
-    vkGetRenderAreaGranularity = reinterpret_cast<PFN_vkGetRenderAreaGranularity>(dlsym(libvulkan, "vkGetRenderAreaGranularity"));
-    vkCreateCommandPool = reinterpret_cast<PFN_vkCreateCommandPool>(dlsym(libvulkan, "vkCreateCommandPool"));
-    vkDestroyCommandPool = reinterpret_cast<PFN_vkDestroyCommandPool>(dlsym(libvulkan, "vkDestroyCommandPool"));
-    vkResetCommandPool = reinterpret_cast<PFN_vkResetCommandPool>(dlsym(libvulkan, "vkResetCommandPool"));
-    vkAllocateCommandBuffers = reinterpret_cast<PFN_vkAllocateCommandBuffers>(dlsym(libvulkan, "vkAllocateCommandBuffers"));
-    vkFreeCommandBuffers = reinterpret_cast<PFN_vkFreeCommandBuffers>(dlsym(libvulkan, "vkFreeCommandBuffers"));
-    vkBeginCommandBuffer = reinterpret_cast<PFN_vkBeginCommandBuffer>(dlsym(libvulkan, "vkBeginCommandBuffer"));
-    vkEndCommandBuffer = reinterpret_cast<PFN_vkEndCommandBuffer>(dlsym(libvulkan, "vkEndCommandBuffer"));
-    vkResetCommandBuffer = reinterpret_cast<PFN_vkResetCommandBuffer>(dlsym(libvulkan, "vkResetCommandBuffer"));
-    vkCmdBindPipeline = reinterpret_cast<PFN_vkCmdBindPipeline>(dlsym(libvulkan, "vkCmdBindPipeline"));
-    vkCmdSetViewport = reinterpret_cast<PFN_vkCmdSetViewport>(dlsym(libvulkan, "vkCmdSetViewport"));
-    vkCmdSetScissor = reinterpret_cast<PFN_vkCmdSetScissor>(dlsym(libvulkan, "vkCmdSetScissor"));
-    vkCmdSetLineWidth = reinterpret_cast<PFN_vkCmdSetLineWidth>(dlsym(libvulkan, "vkCmdSetLineWidth"));
-    vkCmdSetDepthBias = reinterpret_cast<PFN_vkCmdSetDepthBias>(dlsym(libvulkan, "vkCmdSetDepthBias"));
-    vkCmdSetBlendConstants = reinterpret_cast<PFN_vkCmdSetBlendConstants>(dlsym(libvulkan, "vkCmdSetBlendConstants"));
-    vkCmdSetDepthBounds = reinterpret_cast<PFN_vkCmdSetDepthBounds>(dlsym(libvulkan, "vkCmdSetDepthBounds"));
-    vkCmdSetStencilCompareMask = reinterpret_cast<PFN_vkCmdSetStencilCompareMask>(dlsym(libvulkan, "vkCmdSetStencilCompareMask"));
-    vkCmdSetStencilWriteMask = reinterpret_cast<PFN_vkCmdSetStencilWriteMask>(dlsym(libvulkan, "vkCmdSetStencilWriteMask"));
-    vkCmdSetStencilReference = reinterpret_cast<PFN_vkCmdSetStencilReference>(dlsym(libvulkan, "vkCmdSetStencilReference"));
-    vkCmdBindDescriptorSets = reinterpret_cast<PFN_vkCmdBindDescriptorSets>(dlsym(libvulkan, "vkCmdBindDescriptorSets"));
-    vkCmdBindIndexBuffer = reinterpret_cast<PFN_vkCmdBindIndexBuffer>(dlsym(libvulkan, "vkCmdBindIndexBuffer"));
-    vkCmdBindVertexBuffers = reinterpret_cast<PFN_vkCmdBindVertexBuffers>(dlsym(libvulkan, "vkCmdBindVertexBuffers"));
-    vkCmdDraw = reinterpret_cast<PFN_vkCmdDraw>(dlsym(libvulkan, "vkCmdDraw"));
-    vkCmdDrawIndexed = reinterpret_cast<PFN_vkCmdDrawIndexed>(dlsym(libvulkan, "vkCmdDrawIndexed"));
-    vkCmdDrawIndirect = reinterpret_cast<PFN_vkCmdDrawIndirect>(dlsym(libvulkan, "vkCmdDrawIndirect"));
-    vkCmdDrawIndexedIndirect = reinterpret_cast<PFN_vkCmdDrawIndexedIndirect>(dlsym(libvulkan, "vkCmdDrawIndexedIndirect"));
-    vkCmdDispatch = reinterpret_cast<PFN_vkCmdDispatch>(dlsym(libvulkan, "vkCmdDispatch"));
-    vkCmdDispatchIndirect = reinterpret_cast<PFN_vkCmdDispatchIndirect>(dlsym(libvulkan, "vkCmdDispatchIndirect"));
-    vkCmdCopyBuffer = reinterpret_cast<PFN_vkCmdCopyBuffer>(dlsym(libvulkan, "vkCmdCopyBuffer"));
-    vkCmdCopyImage = reinterpret_cast<PFN_vkCmdCopyImage>(dlsym(libvulkan, "vkCmdCopyImage"));
-    vkCmdBlitImage = reinterpret_cast<PFN_vkCmdBlitImage>(dlsym(libvulkan, "vkCmdBlitImage"));
-    vkCmdCopyBufferToImage = reinterpret_cast<PFN_vkCmdCopyBufferToImage>(dlsym(libvulkan, "vkCmdCopyBufferToImage"));
-    vkCmdCopyImageToBuffer = reinterpret_cast<PFN_vkCmdCopyImageToBuffer>(dlsym(libvulkan, "vkCmdCopyImageToBuffer"));
-    vkCmdUpdateBuffer = reinterpret_cast<PFN_vkCmdUpdateBuffer>(dlsym(libvulkan, "vkCmdUpdateBuffer"));
-    vkCmdFillBuffer = reinterpret_cast<PFN_vkCmdFillBuffer>(dlsym(libvulkan, "vkCmdFillBuffer"));
-    vkCmdClearColorImage = reinterpret_cast<PFN_vkCmdClearColorImage>(dlsym(libvulkan, "vkCmdClearColorImage"));
-    vkCmdClearDepthStencilImage = reinterpret_cast<PFN_vkCmdClearDepthStencilImage>(dlsym(libvulkan, "vkCmdClearDepthStencilImage"));
-    vkCmdClearAttachments = reinterpret_cast<PFN_vkCmdClearAttachments>(dlsym(libvulkan, "vkCmdClearAttachments"));
-    vkCmdResolveImage = reinterpret_cast<PFN_vkCmdResolveImage>(dlsym(libvulkan, "vkCmdResolveImage"));
-    vkCmdSetEvent = reinterpret_cast<PFN_vkCmdSetEvent>(dlsym(libvulkan, "vkCmdSetEvent"));
-    vkCmdResetEvent = reinterpret_cast<PFN_vkCmdResetEvent>(dlsym(libvulkan, "vkCmdResetEvent"));
-    vkCmdWaitEvents = reinterpret_cast<PFN_vkCmdWaitEvents>(dlsym(libvulkan, "vkCmdWaitEvents"));
-    vkCmdPipelineBarrier = reinterpret_cast<PFN_vkCmdPipelineBarrier>(dlsym(libvulkan, "vkCmdPipelineBarrier"));
-    vkCmdBeginQuery = reinterpret_cast<PFN_vkCmdBeginQuery>(dlsym(libvulkan, "vkCmdBeginQuery"));
-    vkCmdEndQuery = reinterpret_cast<PFN_vkCmdEndQuery>(dlsym(libvulkan, "vkCmdEndQuery"));
-    vkCmdResetQueryPool = reinterpret_cast<PFN_vkCmdResetQueryPool>(dlsym(libvulkan, "vkCmdResetQueryPool"));
-    vkCmdWriteTimestamp = reinterpret_cast<PFN_vkCmdWriteTimestamp>(dlsym(libvulkan, "vkCmdWriteTimestamp"));
-    vkCmdCopyQueryPoolResults = reinterpret_cast<PFN_vkCmdCopyQueryPoolResults>(dlsym(libvulkan, "vkCmdCopyQueryPoolResults"));
-    vkCmdPushConstants = reinterpret_cast<PFN_vkCmdPushConstants>(dlsym(libvulkan, "vkCmdPushConstants"));
-    vkCmdBeginRenderPass = reinterpret_cast<PFN_vkCmdBeginRenderPass>(dlsym(libvulkan, "vkCmdBeginRenderPass"));
-    vkCmdNextSubpass = reinterpret_cast<PFN_vkCmdNextSubpass>(dlsym(libvulkan, "vkCmdNextSubpass"));
-    vkCmdEndRenderPass = reinterpret_cast<PFN_vkCmdEndRenderPass>(dlsym(libvulkan, "vkCmdEndRenderPass"));
-    vkCmdExecuteCommands = reinterpret_cast<PFN_vkCmdExecuteCommands>(dlsym(libvulkan, "vkCmdExecuteCommands"));
-    vkDestroySurfaceKHR = reinterpret_cast<PFN_vkDestroySurfaceKHR>(dlsym(libvulkan, "vkDestroySurfaceKHR"));
-    vkGetPhysicalDeviceSurfaceSupportKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceSurfaceSupportKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceSurfaceSupportKHR"));
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceSurfaceCapabilitiesKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR"));
-    vkGetPhysicalDeviceSurfaceFormatsKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceSurfaceFormatsKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceSurfaceFormatsKHR"));
-    vkGetPhysicalDeviceSurfacePresentModesKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceSurfacePresentModesKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceSurfacePresentModesKHR"));
-    vkCreateSwapchainKHR = reinterpret_cast<PFN_vkCreateSwapchainKHR>(dlsym(libvulkan, "vkCreateSwapchainKHR"));
-    vkDestroySwapchainKHR = reinterpret_cast<PFN_vkDestroySwapchainKHR>(dlsym(libvulkan, "vkDestroySwapchainKHR"));
-    vkGetSwapchainImagesKHR = reinterpret_cast<PFN_vkGetSwapchainImagesKHR>(dlsym(libvulkan, "vkGetSwapchainImagesKHR"));
-    vkAcquireNextImageKHR = reinterpret_cast<PFN_vkAcquireNextImageKHR>(dlsym(libvulkan, "vkAcquireNextImageKHR"));
-    vkQueuePresentKHR = reinterpret_cast<PFN_vkQueuePresentKHR>(dlsym(libvulkan, "vkQueuePresentKHR"));
-    vkGetPhysicalDeviceDisplayPropertiesKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceDisplayPropertiesKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceDisplayPropertiesKHR"));
-    vkGetPhysicalDeviceDisplayPlanePropertiesKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceDisplayPlanePropertiesKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceDisplayPlanePropertiesKHR"));
-    vkGetDisplayPlaneSupportedDisplaysKHR = reinterpret_cast<PFN_vkGetDisplayPlaneSupportedDisplaysKHR>(dlsym(libvulkan, "vkGetDisplayPlaneSupportedDisplaysKHR"));
-    vkGetDisplayModePropertiesKHR = reinterpret_cast<PFN_vkGetDisplayModePropertiesKHR>(dlsym(libvulkan, "vkGetDisplayModePropertiesKHR"));
-    vkCreateDisplayModeKHR = reinterpret_cast<PFN_vkCreateDisplayModeKHR>(dlsym(libvulkan, "vkCreateDisplayModeKHR"));
-    vkGetDisplayPlaneCapabilitiesKHR = reinterpret_cast<PFN_vkGetDisplayPlaneCapabilitiesKHR>(dlsym(libvulkan, "vkGetDisplayPlaneCapabilitiesKHR"));
-    vkCreateDisplayPlaneSurfaceKHR = reinterpret_cast<PFN_vkCreateDisplayPlaneSurfaceKHR>(dlsym(libvulkan, "vkCreateDisplayPlaneSurfaceKHR"));
-    vkCreateSharedSwapchainsKHR = reinterpret_cast<PFN_vkCreateSharedSwapchainsKHR>(dlsym(libvulkan, "vkCreateSharedSwapchainsKHR"));
+    // Vulkan supported, install the lazy stubs
+    VK_LAZY(vkCreateInstance);
+    VK_LAZY(vkDestroyInstance);
+    VK_LAZY(vkEnumeratePhysicalDevices);
+    VK_LAZY(vkGetPhysicalDeviceFeatures);
+    VK_LAZY(vkGetPhysicalDeviceFormatProperties);
+    VK_LAZY(vkGetPhysicalDeviceImageFormatProperties);
+    VK_LAZY(vkGetPhysicalDeviceProperties);
+    VK_LAZY(vkGetPhysicalDeviceQueueFamilyProperties);
+    VK_LAZY(vkGetPhysicalDeviceMemoryProperties);
+    VK_LAZY(vkGetInstanceProcAddr);
+    VK_LAZY(vkGetDeviceProcAddr);
+    VK_LAZY(vkCreateDevice);
+    VK_LAZY(vkDestroyDevice);
+    VK_LAZY(vkEnumerateInstanceExtensionProperties);
+    VK_LAZY(vkEnumerateDeviceExtensionProperties);
+    VK_LAZY(vkEnumerateInstanceLayerProperties);
+    VK_LAZY(vkEnumerateDeviceLayerProperties);
+    VK_LAZY(vkGetDeviceQueue);
+    VK_LAZY(vkQueueSubmit);
+    VK_LAZY(vkQueueWaitIdle);
+    VK_LAZY(vkDeviceWaitIdle);
+    VK_LAZY(vkAllocateMemory);
+    VK_LAZY(vkFreeMemory);
+    VK_LAZY(vkMapMemory);
+    VK_LAZY(vkUnmapMemory);
+    VK_LAZY(vkFlushMappedMemoryRanges);
+    VK_LAZY(vkInvalidateMappedMemoryRanges);
+    VK_LAZY(vkGetDeviceMemoryCommitment);
+    VK_LAZY(vkBindBufferMemory);
+    VK_LAZY(vkBindImageMemory);
+    VK_LAZY(vkGetBufferMemoryRequirements);
+    VK_LAZY(vkGetImageMemoryRequirements);
+    VK_LAZY(vkGetImageSparseMemoryRequirements);
+    VK_LAZY(vkGetPhysicalDeviceSparseImageFormatProperties);
+    VK_LAZY(vkQueueBindSparse);
+    VK_LAZY(vkCreateFence);
+    VK_LAZY(vkDestroyFence);
+    VK_LAZY(vkResetFences);
+    VK_LAZY(vkGetFenceStatus);
+    VK_LAZY(vkWaitForFences);
+    VK_LAZY(vkCreateSemaphore);
+    VK_LAZY(vkDestroySemaphore);
+    VK_LAZY(vkCreateEvent);
+    VK_LAZY(vkDestroyEvent);
+    VK_LAZY(vkGetEventStatus);
+    VK_LAZY(vkSetEvent);
+    VK_LAZY(vkResetEvent);
+    VK_LAZY(vkCreateQueryPool);
+    VK_LAZY(vkDestroyQueryPool);
+    VK_LAZY(vkGetQueryPoolResults);
+    VK_LAZY(vkCreateBuffer);
+    VK_LAZY(vkDestroyBuffer);
+    VK_LAZY(vkCreateBufferView);
+    VK_LAZY(vkDestroyBufferView);
+    VK_LAZY(vkCreateImage);
+    VK_LAZY(vkDestroyImage);
+    VK_LAZY(vkGetImageSubresourceLayout);
+    VK_LAZY(vkCreateImageView);
+    VK_LAZY(vkDestroyImageView);
+    VK_LAZY(vkCreateShaderModule);
+    VK_LAZY(vkDestroyShaderModule);
+    VK_LAZY(vkCreatePipelineCache);
+    VK_LAZY(vkDestroyPipelineCache);
+    VK_LAZY(vkGetPipelineCacheData);
+    VK_LAZY(vkMergePipelineCaches);
+    VK_LAZY(vkCreateGraphicsPipelines);
+    VK_LAZY(vkCreateComputePipelines);
+    VK_LAZY(vkDestroyPipeline);
+    VK_LAZY(vkCreatePipelineLayout);
+    VK_LAZY(vkDestroyPipelineLayout);
+    VK_LAZY(vkCreateSampler);
+    VK_LAZY(vkDestroySampler);
+    VK_LAZY(vkCreateDescriptorSetLayout);
+    VK_LAZY(vkDestroyDescriptorSetLayout);
+    VK_LAZY(vkCreateDescriptorPool);
+    VK_LAZY(vkDestroyDescriptorPool);
+    VK_LAZY(vkResetDescriptorPool);
+    VK_LAZY(vkAllocateDescriptorSets);
+    VK_LAZY(vkFreeDescriptorSets);
+    VK_LAZY(vkUpdateDescriptorSets);
+    VK_LAZY(vkCreateFramebuffer);
+    VK_LAZY(vkDestroyFramebuffer);
+    VK_LAZY(vkCreateRenderPass);
+    VK_LAZY(vkDestroyRenderPass);
+    VK_LAZY(vkGetRenderAreaGranularity);
+    VK_LAZY(vkCreateCommandPool);
+    VK_LAZY(vkDestroyCommandPool);
+    VK_LAZY(vkResetCommandPool);
+    VK_LAZY(vkAllocateCommandBuffers);
+    VK_LAZY(vkFreeCommandBuffers);
+    VK_LAZY(vkBeginCommandBuffer);
+    VK_LAZY(vkEndCommandBuffer);
+    VK_LAZY(vkResetCommandBuffer);
+    VK_LAZY(vkCmdBindPipeline);
+    VK_LAZY(vkCmdSetViewport);
+    VK_LAZY(vkCmdSetScissor);
+    VK_LAZY(vkCmdSetLineWidth);
+    VK_LAZY(vkCmdSetDepthBias);
+    VK_LAZY(vkCmdSetBlendConstants);
+    VK_LAZY(vkCmdSetDepthBounds);
+    VK_LAZY(vkCmdSetStencilCompareMask);
+    VK_LAZY(vkCmdSetStencilWriteMask);
+    VK_LAZY(vkCmdSetStencilReference);
+    VK_LAZY(vkCmdBindDescriptorSets);
+    VK_LAZY(vkCmdBindIndexBuffer);
+    VK_LAZY(vkCmdBindVertexBuffers);
+    VK_LAZY(vkCmdDraw);
+    VK_LAZY(vkCmdDrawIndexed);
+    VK_LAZY(vkCmdDrawIndirect);
+    VK_LAZY(vkCmdDrawIndexedIndirect);
+    VK_LAZY(vkCmdDispatch);
+    VK_LAZY(vkCmdDispatchIndirect);
+    VK_LAZY(vkCmdCopyBuffer);
+    VK_LAZY(vkCmdCopyImage);
+    VK_LAZY(vkCmdBlitImage);
+    VK_LAZY(vkCmdCopyBufferToImage);
+    VK_LAZY(vkCmdCopyImageToBuffer);
+    VK_LAZY(vkCmdUpdateBuffer);
+    VK_LAZY(vkCmdFillBuffer);
+    VK_LAZY(vkCmdClearColorImage);
+    VK_LAZY(vkCmdClearDepthStencilImage);
+    VK_LAZY(vkCmdClearAttachments);
+    VK_LAZY(vkCmdResolveImage);
+    VK_LAZY(vkCmdSetEvent);
+    VK_LAZY(vkCmdResetEvent);
+    VK_LAZY(vkCmdWaitEvents);
+    VK_LAZY(vkCmdPipelineBarrier);
+    VK_LAZY(vkCmdBeginQuery);
+    VK_LAZY(vkCmdEndQuery);
+    VK_LAZY(vkCmdResetQueryPool);
+    VK_LAZY(vkCmdWriteTimestamp);
+    VK_LAZY(vkCmdCopyQueryPoolResults);
+    VK_LAZY(vkCmdPushConstants);
+    VK_LAZY(vkCmdBeginRenderPass);
+    VK_LAZY(vkCmdNextSubpass);
+    VK_LAZY(vkCmdEndRenderPass);
+    VK_LAZY(vkCmdExecuteCommands);
+    VK_LAZY(vkDestroySurfaceKHR);
+    VK_LAZY(vkGetPhysicalDeviceSurfaceSupportKHR);
+    VK_LAZY(vkGetPhysicalDeviceSurfaceCapabilitiesKHR);
+    VK_LAZY(vkGetPhysicalDeviceSurfaceFormatsKHR);
+    VK_LAZY(vkGetPhysicalDeviceSurfacePresentModesKHR);
+    VK_LAZY(vkCreateSwapchainKHR);
+    VK_LAZY(vkDestroySwapchainKHR);
+    VK_LAZY(vkGetSwapchainImagesKHR);
+    VK_LAZY(vkAcquireNextImageKHR);
+    VK_LAZY(vkQueuePresentKHR);
+    VK_LAZY(vkGetPhysicalDeviceDisplayPropertiesKHR);
+    VK_LAZY(vkGetPhysicalDeviceDisplayPlanePropertiesKHR);
+    VK_LAZY(vkGetDisplayPlaneSupportedDisplaysKHR);
+    VK_LAZY(vkGetDisplayModePropertiesKHR);
+    VK_LAZY(vkCreateDisplayModeKHR);
+    VK_LAZY(vkGetDisplayPlaneCapabilitiesKHR);
+    VK_LAZY(vkCreateDisplayPlaneSurfaceKHR);
+    VK_LAZY(vkCreateSharedSwapchainsKHR);
 
 #ifdef VK_USE_PLATFORM_XLIB_KHR
-    vkCreateXlibSurfaceKHR = reinterpret_cast<PFN_vkCreateXlibSurfaceKHR>(dlsym(libvulkan, "vkCreateXlibSurfaceKHR"));
-    vkGetPhysicalDeviceXlibPresentationSupportKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceXlibPresentationSupportKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceXlibPresentationSupportKHR"));
+    VK_LAZY(vkCreateXlibSurfaceKHR);
+    VK_LAZY(vkGetPhysicalDeviceXlibPresentationSupportKHR);
 #endif
 
 #ifdef VK_USE_PLATFORM_XCB_KHR
-    vkCreateXcbSurfaceKHR = reinterpret_cast<PFN_vkCreateXcbSurfaceKHR>(dlsym(libvulkan, "vkCreateXcbSurfaceKHR"));
-    vkGetPhysicalDeviceXcbPresentationSupportKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceXcbPresentationSupportKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceXcbPresentationSupportKHR"));
+    VK_LAZY(vkCreateXcbSurfaceKHR);
+    VK_LAZY(vkGetPhysicalDeviceXcbPresentationSupportKHR);
 #endif
 
 #ifdef VK_USE_PLATFORM_WAYLAND_KHR
-    vkCreateWaylandSurfaceKHR = reinterpret_cast<PFN_vkCreateWaylandSurfaceKHR>(dlsym(libvulkan, "vkCreateWaylandSurfaceKHR"));
-    vkGetPhysicalDeviceWaylandPresentationSupportKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceWaylandPresentationSupportKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceWaylandPresentationSupportKHR"));
+    VK_LAZY(vkCreateWaylandSurfaceKHR);
+    VK_LAZY(vkGetPhysicalDeviceWaylandPresentationSupportKHR);
 #endif
 
 #ifdef VK_USE_PLATFORM_MIR_KHR
-    vkCreateMirSurfaceKHR = reinterpret_cast<PFN_vkCreateMirSurfaceKHR>(dlsym(libvulkan, "vkCreateMirSurfaceKHR"));
-    vkGetPhysicalDeviceMirPresentationSupportKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceMirPresentationSupportKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceMirPresentationSupportKHR"));
+    VK_LAZY(vkCreateMirSurfaceKHR);
+    VK_LAZY(vkGetPhysicalDeviceMirPresentationSupportKHR);
 #endif
 
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
-    vkCreateAndroidSurfaceKHR = reinterpret_cast<PFN_vkCreateAndroidSurfaceKHR>(dlsym(libvulkan, "vkCreateAndroidSurfaceKHR"));
+    VK_LAZY(vkCreateAndroidSurfaceKHR);
 #endif
 
 #ifdef VK_USE_PLATFORM_WIN32_KHR
-    vkCreateWin32SurfaceKHR = reinterpret_cast<PFN_vkCreateWin32SurfaceKHR>(dlsym(libvulkan, "vkCreateWin32SurfaceKHR"));
-    vkGetPhysicalDeviceWin32PresentationSupportKHR = reinterpret_cast<PFN_vkGetPhysicalDeviceWin32PresentationSupportKHR>(dlsym(libvulkan, "vkGetPhysicalDeviceWin32PresentationSupportKHR"));
+    VK_LAZY(vkCreateWin32SurfaceKHR);
+    VK_LAZY(vkGetPhysicalDeviceWin32PresentationSupportKHR);
 #endif
 #ifdef USE_DEBUG_EXTENTIONS
-    vkCreateDebugReportCallbackEXT = reinterpret_cast<PFN_vkCreateDebugReportCallbackEXT>(dlsym(libvulkan, "vkCreateDebugReportCallbackEXT"));
-    vkDestroyDebugReportCallbackEXT = reinterpret_cast<PFN_vkDestroyDebugReportCallbackEXT>(dlsym(libvulkan, "vkDestroyDebugReportCallbackEXT"));
-    vkDebugReportMessageEXT = reinterpret_cast<PFN_vkDebugReportMessageEXT>(dlsym(libvulkan, "vkDebugReportMessageEXT"));
+    VK_LAZY(vkCreateDebugReportCallbackEXT);
+    VK_LAZY(vkDestroyDebugReportCallbackEXT);
+    VK_LAZY(vkDebugReportMessageEXT);
 #endif
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    __android_log_print(ANDROID_LOG_INFO, "RyujinxVulkan", "InitVulkan took %lld us", static_cast<long long>(elapsed));
     return 1;
 }
 
+int GetVulkanResolvedSymbolCount(void) {
+    return s_lazyResolvedCount.load(std::memory_order_relaxed);
+}
+
 // No Vulkan support, do not set function addresses
 PFN_vkCreateInstance vkCreateInstance;
 PFN_vkDestroyInstance vkDestroyInstance;
@@ -402,3 +466,110 @@ PFN_vkCreateDebugReportCallbackEXT vkCreateDebugReportCallbackEXT;
 PFN_vkDestroyDebugReportCallbackEXT vkDestroyDebugReportCallbackEXT;
 PFN_vkDebugReportMessageEXT vkDebugReportMessageEXT;
 
+
+// Device level dispatch
+#include <mutex>
+#include <string.h>
+
+namespace {
+
+constexpr int MaxVulkanDevices = 4;
+
+std::mutex s_deviceDispatchLock;
+VulkanDeviceDispatch s_deviceDispatch[MaxVulkanDevices];
+void* s_driverLibrary = nullptr;
+PFN_vkGetDeviceProcAddr s_getDeviceProcAddr = nullptr;
+
+void LoadDeviceDriver() {
+    if (s_getDeviceProcAddr)
+        return;
+
+    if (!s_driverLibrary)
+        s_driverLibrary = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+    if (s_driverLibrary)
+        s_getDeviceProcAddr = reinterpret_cast<PFN_vkGetDeviceProcAddr>(dlsym(s_driverLibrary, "vkGetDeviceProcAddr"));
+}
+
+void PopulateDeviceDispatch(VulkanDeviceDispatch* table) {
+#define VULKAN_DISPATCH_LOAD(name) \
+    table->name = reinterpret_cast<PFN_##name>(s_getDeviceProcAddr(table->device, #name));
+    VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_LOAD)
+#undef VULKAN_DISPATCH_LOAD
+}
+
+VulkanDeviceDispatch* FindDeviceDispatch(VkDevice device) {
+    for (auto& table : s_deviceDispatch) {
+        if (table.device == device)
+            return &table;
+    }
+    return nullptr;
+}
+
+// Caller holds s_deviceDispatchLock
+VulkanDeviceDispatch* AcquireDeviceDispatch(VkDevice device) {
+    LoadDeviceDriver();
+    if (!s_getDeviceProcAddr)
+        return nullptr;
+
+    auto table = FindDeviceDispatch(device);
+    if (table)
+        return table;
+
+    table = FindDeviceDispatch(VK_NULL_HANDLE);
+    if (!table)
+        return nullptr;
+
+    table->device = device;
+    PopulateDeviceDispatch(table);
+    return table;
+}
+
+}
+
+void SetVulkanDriver(void* driverHandle) {
+    TRACE_SCOPE("SetVulkanDriver");
+    std::lock_guard<std::mutex> guard(s_deviceDispatchLock);
+
+    s_driverLibrary = driverHandle;
+    s_getDeviceProcAddr = nullptr;
+    LoadDeviceDriver();
+
+    for (auto& table : s_deviceDispatch) {
+        if (table.device == VK_NULL_HANDLE)
+            continue;
+        if (s_getDeviceProcAddr)
+            PopulateDeviceDispatch(&table);
+        else
+            table = VulkanDeviceDispatch{};
+    }
+}
+
+void ReleaseVulkanDevice(VkDevice device) {
+    std::lock_guard<std::mutex> guard(s_deviceDispatchLock);
+
+    auto table = device != VK_NULL_HANDLE ? FindDeviceDispatch(device) : nullptr;
+    if (table)
+        *table = VulkanDeviceDispatch{};
+}
+
+PFN_vkVoidFunction GetVulkanDeviceFunction(VkDevice device, const char* name) {
+    if (device == VK_NULL_HANDLE)
+        return nullptr;
+
+    // The slot can be released and reused as soon as the lock is dropped, so the
+    // pointer is copied out while it is still held
+    std::lock_guard<std::mutex> guard(s_deviceDispatchLock);
+
+    auto table = AcquireDeviceDispatch(device);
+    if (!table)
+        return nullptr;
+
+#define VULKAN_DISPATCH_FIND(fn) \
+    if (strcmp(name, #fn) == 0) \
+        return reinterpret_cast<PFN_vkVoidFunction>(table->fn);
+    VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_FIND)
+#undef VULKAN_DISPATCH_FIND
+
+    // Extension entry points are not cached but still resolve past the loader
+    return s_getDeviceProcAddr(device, name);
+}
@@ -24,6 +24,9 @@
  */
 int InitVulkan(void);
 
+/* Number of entry points resolved so far by their first call, for startup profiling. */
+int GetVulkanResolvedSymbolCount(void);
+
 // VK_core
 extern PFN_vkCreateInstance vkCreateInstance;
 extern PFN_vkDestroyInstance vkDestroyInstance;
@@ -233,4 +236,155 @@ extern PFN_vkDebugReportMessageEXT vkDebugReportMessageEXT;
 #endif
 
 
+// Device level dispatch
+// Entry points resolved through vkGetDeviceProcAddr for one VkDevice. Calls made through these
+// go straight to the driver instead of the loader trampoline that dlsym hands out.
+#define VULKAN_DEVICE_FUNCTIONS(X) \
+    X(vkDestroyDevice) \
+    X(vkGetDeviceQueue) \
+    X(vkQueueSubmit) \
+    X(vkQueueWaitIdle) \
+    X(vkDeviceWaitIdle) \
+    X(vkAllocateMemory) \
+    X(vkFreeMemory) \
+    X(vkMapMemory) \
+    X(vkUnmapMemory) \
+    X(vkFlushMappedMemoryRanges) \
+    X(vkInvalidateMappedMemoryRanges) \
+    X(vkGetDeviceMemoryCommitment) \
+    X(vkBindBufferMemory) \
+    X(vkBindImageMemory) \
+    X(vkGetBufferMemoryRequirements) \
+    X(vkGetImageMemoryRequirements) \
+    X(vkGetImageSparseMemoryRequirements) \
+    X(vkQueueBindSparse) \
+    X(vkCreateFence) \
+    X(vkDestroyFence) \
+    X(vkResetFences) \
+    X(vkGetFenceStatus) \
+    X(vkWaitForFences) \
+    X(vkCreateSemaphore) \
+    X(vkDestroySemaphore) \
+    X(vkCreateEvent) \
+    X(vkDestroyEvent) \
+    X(vkGetEventStatus) \
+    X(vkSetEvent) \
+    X(vkResetEvent) \
+    X(vkCreateQueryPool) \
+    X(vkDestroyQueryPool) \
+    X(vkGetQueryPoolResults) \
+    X(vkCreateBuffer) \
+    X(vkDestroyBuffer) \
+    X(vkCreateBufferView) \
+    X(vkDestroyBufferView) \
+    X(vkCreateImage) \
+    X(vkDestroyImage) \
+    X(vkGetImageSubresourceLayout) \
+    X(vkCreateImageView) \
+    X(vkDestroyImageView) \
+    X(vkCreateShaderModule) \
+    X(vkDestroyShaderModule) \
+    X(vkCreatePipelineCache) \
+    X(vkDestroyPipelineCache) \
+    X(vkGetPipelineCacheData) \
+    X(vkMergePipelineCaches) \
+    X(vkCreateGraphicsPipelines) \
+    X(vkCreateComputePipelines) \
+    X(vkDestroyPipeline) \
+    X(vkCreatePipelineLayout) \
+    X(vkDestroyPipelineLayout) \
+    X(vkCreateSampler) \
+    X(vkDestroySampler) \
+    X(vkCreateDescriptorSetLayout) \
+    X(vkDestroyDescriptorSetLayout) \
+    X(vkCreateDescriptorPool) \
+    X(vkDestroyDescriptorPool) \
+    X(vkResetDescriptorPool) \
+    X(vkAllocateDescriptorSets) \
+    X(vkFreeDescriptorSets) \
+    X(vkUpdateDescriptorSets) \
+    X(vkCreateFramebuffer) \
+    X(vkDestroyFramebuffer) \
+    X(vkCreateRenderPass) \
+    X(vkDestroyRenderPass) \
+    X(vkGetRenderAreaGranularity) \
+    X(vkCreateCommandPool) \
+    X(vkDestroyCommandPool) \
+    X(vkResetCommandPool) \
+    X(vkAllocateCommandBuffers) \
+    X(vkFreeCommandBuffers) \
+    X(vkBeginCommandBuffer) \
+    X(vkEndCommandBuffer) \
+    X(vkResetCommandBuffer) \
+    X(vkCmdBindPipeline) \
+    X(vkCmdSetViewport) \
+    X(vkCmdSetScissor) \
+    X(vkCmdSetLineWidth) \
+    X(vkCmdSetDepthBias) \
+    X(vkCmdSetBlendConstants) \
+    X(vkCmdSetDepthBounds) \
+    X(vkCmdSetStencilCompareMask) \
+    X(vkCmdSetStencilWriteMask) \
+    X(vkCmdSetStencilReference) \
+    X(vkCmdBindDescriptorSets) \
+    X(vkCmdBindIndexBuffer) \
+    X(vkCmdBindVertexBuffers) \
+    X(vkCmdDraw) \
+    X(vkCmdDrawIndexed) \
+    X(vkCmdDrawIndirect) \
+    X(vkCmdDrawIndexedIndirect) \
+    X(vkCmdDispatch) \
+    X(vkCmdDispatchIndirect) \
+    X(vkCmdCopyBuffer) \
+    X(vkCmdCopyImage) \
+    X(vkCmdBlitImage) \
+    X(vkCmdCopyBufferToImage) \
+    X(vkCmdCopyImageToBuffer) \
+    X(vkCmdUpdateBuffer) \
+    X(vkCmdFillBuffer) \
+    X(vkCmdClearColorImage) \
+    X(vkCmdClearDepthStencilImage) \
+    X(vkCmdClearAttachments) \
+    X(vkCmdResolveImage) \
+    X(vkCmdSetEvent) \
+    X(vkCmdResetEvent) \
+    X(vkCmdWaitEvents) \
+    X(vkCmdPipelineBarrier) \
+    X(vkCmdBeginQuery) \
+    X(vkCmdEndQuery) \
+    X(vkCmdResetQueryPool) \
+    X(vkCmdWriteTimestamp) \
+    X(vkCmdCopyQueryPoolResults) \
+    X(vkCmdPushConstants) \
+    X(vkCmdBeginRenderPass) \
+    X(vkCmdNextSubpass) \
+    X(vkCmdEndRenderPass) \
+    X(vkCmdExecuteCommands) \
+    X(vkCreateSwapchainKHR) \
+    X(vkDestroySwapchainKHR) \
+    X(vkGetSwapchainImagesKHR) \
+    X(vkAcquireNextImageKHR) \
+    X(vkQueuePresentKHR) \
+    X(vkCreateSharedSwapchainsKHR)
+
+typedef struct VulkanDeviceDispatch {
+    VkDevice device;
+#define VULKAN_DISPATCH_MEMBER(name) PFN_##name name;
+    VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_MEMBER)
+#undef VULKAN_DISPATCH_MEMBER
+} VulkanDeviceDispatch;
+
+/* Selects the library device entry points are resolved from, null for the system libvulkan.
+ * Tables of devices that are still registered are re-populated from the new library.
+ */
+void SetVulkanDriver(void* driverHandle);
+
+/* Frees the dispatch table slot of a destroyed device. */
+void ReleaseVulkanDevice(VkDevice device);
+
+/* Looks a device function up by name in the device table, registering the device on first use.
+ * Returns null for functions that are not device level.
+ */
+PFN_vkVoidFunction GetVulkanDeviceFunction(VkDevice device, const char* name);
+
 #endif // VULKAN_WRAPPER_H
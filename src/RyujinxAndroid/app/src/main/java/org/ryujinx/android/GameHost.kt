@@ -7,6 +7,7 @@ import android.view.SurfaceView
 import androidx.compose.runtime.MutableState
 import org.ryujinx.android.viewmodels.GameModel
 import org.ryujinx.android.viewmodels.MainViewModel
+import org.ryujinx.android.viewmodels.QuickSettings
 import kotlin.concurrent.thread
 
 @SuppressLint("ViewConstructor")
@@ -69,6 +70,10 @@ class GameHost(context: Context?, private val mainViewModel: MainViewModel) : Su
             _currentWindow = _nativeWindow.requeryWindowHandle()
 
             _nativeWindow.swapInterval = 0
+
+            val quickSettings = QuickSettings(mainViewModel.activity)
+            NativeHelpers.instance.setSharedBufferMode(quickSettings.enableLowLatencyPresent)
+            NativeHelpers.instance.setPrerotation(quickSettings.enablePrerotation)
         }
 
         _width = width
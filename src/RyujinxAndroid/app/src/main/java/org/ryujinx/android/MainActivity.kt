@@ -38,6 +38,7 @@ class MainActivity : BaseActivity() {
         var AppPath: String = ""
         var StorageHelper: SimpleStorageHelper? = null
         val performanceMonitor = PerformanceMonitor()
+        val nativeEvents = NativeEvents()
 
         @JvmStatic
         fun frameEnded() {
@@ -48,6 +49,11 @@ class MainActivity : BaseActivity() {
             }
             mainViewModel?.gameHost?.hideProgressIndicator()
         }
+
+        @JvmStatic
+        fun onNativeEvents(events: LongArray) {
+            nativeEvents.update(events)
+        }
     }
 
     init {
@@ -0,0 +1,46 @@
+package org.ryujinx.android
+
+// Latest values reported by the native library, in the order of NativeEvent in java_bridge.h
+class NativeEvents {
+    @Volatile
+    var presentWaitNs: Long = 0
+        private set
+
+    @Volatile
+    var guestFrameRate: Float = 0f
+        private set
+
+    @Volatile
+    var swapMultiple: Int = 0
+        private set
+
+    @Volatile
+    var audioUnderruns: Long = 0
+        private set
+
+    @Volatile
+    var audioLatencyNs: Long = 0
+        private set
+
+    @Volatile
+    var thermalStatus: Int = 0
+        private set
+
+    // Called on the render thread, the array is reused by the next call. events[0] has bit n set
+    // when event n changed, the other slots hold stale values and are skipped.
+    fun update(events: LongArray) {
+        val changed = events[0]
+        if (changed and (1L shl 0) != 0L)
+            presentWaitNs = events[1]
+        if (changed and (1L shl 1) != 0L)
+            guestFrameRate = events[2] / 1000f
+        if (changed and (1L shl 2) != 0L)
+            swapMultiple = events[3].toInt()
+        if (changed and (1L shl 3) != 0L)
+            audioUnderruns = events[4]
+        if (changed and (1L shl 4) != 0L)
+            audioLatencyNs = events[5]
+        if (changed and (1L shl 5) != 0L)
+            thermalStatus = events[6].toInt()
+    }
+}
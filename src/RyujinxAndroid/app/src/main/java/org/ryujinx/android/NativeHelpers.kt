@@ -22,10 +22,29 @@ class NativeHelpers {
         driverName: String
     ): Long
 
+    external fun getDriverExtensions(driverHandle: Long): Array<String>
+    external fun getDriverDeviceName(driverHandle: Long): String
+    external fun setPipelineCacheDirectory(path: String)
     external fun setTurboMode(enable: Boolean)
+    external fun setAdaptiveTurbo(enable: Boolean)
     external fun getMaxSwapInterval(nativeWindow: Long): Int
     external fun getMinSwapInterval(nativeWindow: Long): Int
     external fun setSwapInterval(nativeWindow: Long, swapInterval: Int): Int
+    external fun setBufferCount(nativeWindow: Long, bufferCount: Int): Int
+    external fun setDequeueTimeout(nativeWindow: Long, timeoutNs: Long): Int
+    external fun setSharedBufferMode(enable: Boolean)
+    external fun isSharedBufferModeActive(): Boolean
+    external fun setPrerotation(enable: Boolean)
+    external fun setFrameRate(nativeWindow: Long, frameRate: Float): Int
+    external fun setFrameRateMatching(enable: Boolean)
+    external fun getGuestFrameRate(): Float
+    external fun setFramePacing(enable: Boolean)
+    external fun getRefreshPeriod(): Long
+    external fun getSwapMultiple(): Int
+
+    // [count, dequeue p50/p95/p99, queue p50/p95/p99, hold p50/p95/p99] in nanoseconds
+    external fun getPresentStats(): LongArray
+    external fun resetPresentStats()
     external fun getStringJava(ptr: Long): String
     external fun setIsInitialOrientationFlipped(isFlipped: Boolean)
 }
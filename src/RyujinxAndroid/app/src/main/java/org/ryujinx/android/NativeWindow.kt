@@ -6,6 +6,9 @@ class NativeWindow(val surface: SurfaceView) {
     var nativePointer: Long
     private val nativeHelpers: NativeHelpers = NativeHelpers.instance
     private var _swapInterval: Int = 0
+    private var _frameRate: Float = 0f
+    private var _bufferCount: Int = 0
+    private var _dequeueTimeout: Long = -1
 
     var maxSwapInterval: Int = 0
         get() {
@@ -26,6 +29,44 @@ class NativeWindow(val surface: SurfaceView) {
                 _swapInterval = value
         }
 
+    // 2 for latency sensitive titles, 3 for throughput, 0 keeps the driver default
+    var bufferCount: Int
+        get() {
+            return _bufferCount
+        }
+        set(value) {
+            if (nativeHelpers.setBufferCount(nativePointer, value) == 0)
+                _bufferCount = value
+        }
+
+    // Nanoseconds the render thread waits for a free buffer before dropping the frame, -1 waits forever
+    var dequeueTimeout: Long
+        get() {
+            return _dequeueTimeout
+        }
+        set(value) {
+            nativeHelpers.setDequeueTimeout(nativePointer, value)
+            _dequeueTimeout = value
+        }
+
+    // Manual override of the surface frame rate, 0 lets the compositor decide
+    var frameRate: Float
+        get() {
+            return _frameRate
+        }
+        set(value) {
+            if (nativePointer == -1L || nativeHelpers.setFrameRate(nativePointer, value) == 0)
+                _frameRate = value
+        }
+
+    // Whether the current swapchain presents from a single shared image. Requests made through
+    // NativeHelpers.setSharedBufferMode apply on the next swapchain recreation, and read back
+    // false when the driver does not support shared presentable images.
+    val sharedBufferMode: Boolean
+        get() {
+            return nativeHelpers.isSharedBufferModeActive()
+        }
+
     init {
         nativePointer = nativeHelpers.getNativeWindow(surface.holder.surface)
 
@@ -36,6 +77,7 @@ class NativeWindow(val surface: SurfaceView) {
         nativePointer = nativeHelpers.getNativeWindow(surface.holder.surface)
 
         swapInterval = swapInterval
+        dequeueTimeout = dequeueTimeout
 
         return nativePointer
     }
@@ -4,6 +4,8 @@ import android.content.Intent
 import kotlin.math.abs
 
 class PerformanceManager(private val activity: MainActivity) {
+    private var isPerformanceModeEnabled: Boolean? = null
+
     companion object {
         fun force60HzRefreshRate(enable: Boolean, activity: MainActivity) {
             // Hack for MIUI devices since they don't support the standard Android APIs
@@ -25,7 +27,13 @@ class PerformanceManager(private val activity: MainActivity) {
     }
 
     fun setTurboMode(enable: Boolean) {
-        NativeHelpers.instance.setTurboMode(enable)
+        // Called every frame, only forward changes
+        if (isPerformanceModeEnabled == enable)
+            return
+        isPerformanceModeEnabled = enable
+
+        // Turbo is engaged natively only while frames miss their target
+        NativeHelpers.instance.setAdaptiveTurbo(enable)
         force60HzRefreshRate(enable, activity)
     }
 }
@@ -38,6 +38,12 @@ class MainViewModel(val activity: MainActivity) {
     private var usedMemState: MutableState<Int>? = null
     private var totalMemState: MutableState<Int>? = null
     private var frequenciesState: MutableList<Double>? = null
+    private var presentWaitState: MutableState<Double>? = null
+    private var audioLatencyState: MutableState<Double>? = null
+    private var guestFrameRateState: MutableState<Double>? = null
+    private var swapMultipleState: MutableState<Int>? = null
+    private var audioUnderrunsState: MutableState<Int>? = null
+    private var thermalStatusState: MutableState<Int>? = null
     private var progress: MutableState<String>? = null
     private var progressValue: MutableState<Float>? = null
     private var showLoading: MutableState<Boolean>? = null
@@ -110,6 +116,8 @@ class MainViewModel(val activity: MainActivity) {
 
         var driverHandle = 0L
 
+        nativeHelpers.setPipelineCacheDirectory(activity.filesDir.canonicalPath + "/pipeline_cache")
+
         if (driverViewModel.selected.isNotEmpty()) {
             val metaData = drivers.find { it.driverPath == driverViewModel.selected }
 
@@ -117,18 +125,31 @@ class MainViewModel(val activity: MainActivity) {
                 val privatePath = activity.filesDir
                 val privateDriverPath = privatePath.canonicalPath + "/driver/"
                 val pD = File(privateDriverPath)
-                if (pD.exists())
-                    pD.deleteRecursively()
-
                 pD.mkdirs()
 
                 val driver = File(driverViewModel.selected)
                 val parent = driver.parentFile
                 if (parent != null) {
-                    for (file in parent.walkTopDown()) {
-                        if (file.absolutePath == parent.absolutePath)
+                    val sources = parent.walkTopDown()
+                        .filter { it.isFile }
+                        .associateBy { it.name }
+
+                    // Leftovers of a previously selected driver
+                    pD.listFiles()?.forEach {
+                        if (!sources.containsKey(it.name))
+                            it.deleteRecursively()
+                    }
+
+                    // Unchanged files are left in place, so the native side can reuse the driver
+                    // it already loaded instead of opening it again
+                    for ((name, file) in sources) {
+                        val target = File(privateDriverPath + name)
+                        if (target.exists() && target.length() == file.length() &&
+                            target.lastModified() == file.lastModified())
                             continue
-                        file.copyTo(File(privateDriverPath + file.name), true)
+
+                        file.copyTo(target, true)
+                        target.setLastModified(file.lastModified())
                     }
                 }
 
@@ -213,6 +234,8 @@ class MainViewModel(val activity: MainActivity) {
 
         var driverHandle = 0L
 
+        nativeHelpers.setPipelineCacheDirectory(activity.filesDir.canonicalPath + "/pipeline_cache")
+
         if (driverViewModel.selected.isNotEmpty()) {
             val metaData = drivers.find { it.driverPath == driverViewModel.selected }
 
@@ -354,7 +377,13 @@ class MainViewModel(val activity: MainActivity) {
         gameTime: MutableState<Double>,
         usedMem: MutableState<Int>,
         totalMem: MutableState<Int>,
-        frequencies: MutableList<Double>
+        frequencies: MutableList<Double>,
+        presentWait: MutableState<Double>,
+        audioLatency: MutableState<Double>,
+        guestFrameRate: MutableState<Double>,
+        swapMultiple: MutableState<Int>,
+        audioUnderruns: MutableState<Int>,
+        thermalStatus: MutableState<Int>
     ) {
         fifoState = fifo
         gameFpsState = gameFps
@@ -362,6 +391,12 @@ class MainViewModel(val activity: MainActivity) {
         usedMemState = usedMem
         totalMemState = totalMem
         frequenciesState = frequencies
+        presentWaitState = presentWait
+        audioLatencyState = audioLatency
+        guestFrameRateState = guestFrameRate
+        swapMultipleState = swapMultiple
+        audioUnderrunsState = audioUnderruns
+        thermalStatusState = thermalStatus
     }
 
     fun updateStats(
@@ -387,6 +422,26 @@ class MainViewModel(val activity: MainActivity) {
             }
         }
         frequenciesState?.let { MainActivity.performanceMonitor.getFrequencies(it) }
+        presentWaitState?.apply {
+            // p95 time the render thread spent blocked on the swapchain, in ms
+            this.value = MainActivity.nativeEvents.presentWaitNs / 1000000.0
+        }
+        audioLatencyState?.apply {
+            // How far audio written now lands behind the last present, in ms
+            this.value = MainActivity.nativeEvents.audioLatencyNs / 1000000.0
+        }
+        guestFrameRateState?.apply {
+            this.value = MainActivity.nativeEvents.guestFrameRate.toDouble()
+        }
+        swapMultipleState?.apply {
+            this.value = MainActivity.nativeEvents.swapMultiple
+        }
+        audioUnderrunsState?.apply {
+            this.value = MainActivity.nativeEvents.audioUnderruns.toInt()
+        }
+        thermalStatusState?.apply {
+            this.value = MainActivity.nativeEvents.thermalStatus
+        }
     }
 
     fun setGameController(controller: GameController) {
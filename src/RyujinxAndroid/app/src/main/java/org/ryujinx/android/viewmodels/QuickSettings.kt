@@ -19,6 +19,8 @@ class QuickSettings(val activity: Activity) {
     var useSwitchLayout: Boolean
     var enableMotion: Boolean
     var enablePerformanceMode: Boolean
+    var enableLowLatencyPresent: Boolean
+    var enablePrerotation: Boolean
     var controllerStickSensitivity: Float
 
     // Logs
@@ -50,6 +52,8 @@ class QuickSettings(val activity: Activity) {
         useSwitchLayout = sharedPref.getBoolean("useSwitchLayout", true)
         enableMotion = sharedPref.getBoolean("enableMotion", true)
         enablePerformanceMode = sharedPref.getBoolean("enablePerformanceMode", true)
+        enableLowLatencyPresent = sharedPref.getBoolean("enableLowLatencyPresent", false)
+        enablePrerotation = sharedPref.getBoolean("enablePrerotation", false)
         controllerStickSensitivity = sharedPref.getFloat("controllerStickSensitivity", 1.0f)
 
         enableDebugLogs = sharedPref.getBoolean("enableDebugLogs", false)
@@ -80,6 +84,8 @@ class QuickSettings(val activity: Activity) {
         editor.putBoolean("useSwitchLayout", useSwitchLayout)
         editor.putBoolean("enableMotion", enableMotion)
         editor.putBoolean("enablePerformanceMode", enablePerformanceMode)
+        editor.putBoolean("enableLowLatencyPresent", enableLowLatencyPresent)
+        editor.putBoolean("enablePrerotation", enablePrerotation)
         editor.putFloat("controllerStickSensitivity", controllerStickSensitivity)
 
         editor.putBoolean("enableDebugLogs", enableDebugLogs)
@@ -56,6 +56,8 @@ class SettingsViewModel(var navController: NavHostController, val activity: Main
         useSwitchLayout: MutableState<Boolean>,
         enableMotion: MutableState<Boolean>,
         enablePerformanceMode: MutableState<Boolean>,
+        enableLowLatencyPresent: MutableState<Boolean>,
+        enablePrerotation: MutableState<Boolean>,
         controllerStickSensitivity: MutableState<Float>,
         enableDebugLogs: MutableState<Boolean>,
         enableStubLogs: MutableState<Boolean>,
@@ -83,6 +85,8 @@ class SettingsViewModel(var navController: NavHostController, val activity: Main
         useSwitchLayout.value = sharedPref.getBoolean("useSwitchLayout", true)
         enableMotion.value = sharedPref.getBoolean("enableMotion", true)
         enablePerformanceMode.value = sharedPref.getBoolean("enablePerformanceMode", false)
+        enableLowLatencyPresent.value = sharedPref.getBoolean("enableLowLatencyPresent", false)
+        enablePrerotation.value = sharedPref.getBoolean("enablePrerotation", false)
         controllerStickSensitivity.value = sharedPref.getFloat("controllerStickSensitivity", 1.0f)
 
         enableDebugLogs.value = sharedPref.getBoolean("enableDebugLogs", false)
@@ -111,6 +115,8 @@ class SettingsViewModel(var navController: NavHostController, val activity: Main
         useSwitchLayout: MutableState<Boolean>,
         enableMotion: MutableState<Boolean>,
         enablePerformanceMode: MutableState<Boolean>,
+        enableLowLatencyPresent: MutableState<Boolean>,
+        enablePrerotation: MutableState<Boolean>,
         controllerStickSensitivity: MutableState<Float>,
         enableDebugLogs: MutableState<Boolean>,
         enableStubLogs: MutableState<Boolean>,
@@ -138,6 +144,8 @@ class SettingsViewModel(var navController: NavHostController, val activity: Main
         editor.putBoolean("useSwitchLayout", useSwitchLayout.value)
         editor.putBoolean("enableMotion", enableMotion.value)
         editor.putBoolean("enablePerformanceMode", enablePerformanceMode.value)
+        editor.putBoolean("enableLowLatencyPresent", enableLowLatencyPresent.value)
+        editor.putBoolean("enablePrerotation", enablePrerotation.value)
         editor.putFloat("controllerStickSensitivity", controllerStickSensitivity.value)
 
         editor.putBoolean("enableDebugLogs", enableDebugLogs.value)
@@ -354,6 +354,24 @@ class GameViews {
             val frequencies = remember {
                 mutableListOf<Double>()
             }
+            val presentWait = remember {
+                mutableDoubleStateOf(0.0)
+            }
+            val audioLatency = remember {
+                mutableDoubleStateOf(0.0)
+            }
+            val guestFrameRate = remember {
+                mutableDoubleStateOf(0.0)
+            }
+            val swapMultiple = remember {
+                mutableIntStateOf(0)
+            }
+            val audioUnderruns = remember {
+                mutableIntStateOf(0)
+            }
+            val thermalStatus = remember {
+                mutableIntStateOf(0)
+            }
 
             Surface(
                 modifier = Modifier.padding(16.dp),
@@ -367,6 +385,12 @@ class GameViews {
                         Text(text = "${String.format("%.3f", fifo.value)} %")
                         Text(text = "${String.format("%.3f", gameFps.value)} FPS")
                         Text(text = "${String.format("%.3f", gameTimeVal)} ms")
+                        Text(text = "${String.format("%.3f", presentWait.value)} ms wait")
+                        Text(text = "${String.format("%.3f", audioLatency.value)} ms audio")
+                        if (swapMultiple.value > 0)
+                            Text(text = "${String.format("%.1f", guestFrameRate.value)} Hz x${swapMultiple.value}")
+                        Text(text = "${audioUnderruns.value} underruns")
+                        Text(text = "Thermal ${thermalStatus.value}")
                         Box(modifier = Modifier.width(96.dp)) {
                             Column {
                                 LazyColumn {
@@ -397,7 +421,8 @@ class GameViews {
                 }
             }
 
-            mainViewModel.setStatStates(fifo, gameFps, gameTime, usedMem, totalMem, frequencies)
+            mainViewModel.setStatStates(fifo, gameFps, gameTime, usedMem, totalMem, frequencies, presentWait, audioLatency,
+                guestFrameRate, swapMultiple, audioUnderruns, thermalStatus)
         }
     }
 }
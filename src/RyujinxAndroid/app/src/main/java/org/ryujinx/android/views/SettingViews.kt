@@ -131,6 +131,8 @@ class SettingViews {
             val useSwitchLayout = remember { mutableStateOf(true) }
             val enableMotion = remember { mutableStateOf(true) }
             val enablePerformanceMode = remember { mutableStateOf(true) }
+            val enableLowLatencyPresent = remember { mutableStateOf(false) }
+            val enablePrerotation = remember { mutableStateOf(false) }
             val controllerStickSensitivity = remember { mutableStateOf(1.0f) }
 
             val enableDebugLogs = remember { mutableStateOf(true) }
@@ -156,6 +158,8 @@ class SettingViews {
                     useSwitchLayout,
                     enableMotion,
                     enablePerformanceMode,
+                    enableLowLatencyPresent,
+                    enablePrerotation,
                     controllerStickSensitivity,
                     enableDebugLogs,
                     enableStubLogs,
@@ -192,6 +196,8 @@ class SettingViews {
                                     useSwitchLayout,
                                     enableMotion,
                                     enablePerformanceMode,
+                                    enableLowLatencyPresent,
+                                    enablePrerotation,
                                     controllerStickSensitivity,
                                     enableDebugLogs,
                                     enableStubLogs,
@@ -479,6 +485,36 @@ class SettingViews {
                                     enableVsync.value = !enableVsync.value
                                 })
                             }
+                            Row(
+                                modifier = Modifier
+                                    .fillMaxWidth()
+                                    .padding(8.dp),
+                                horizontalArrangement = Arrangement.SpaceBetween,
+                                verticalAlignment = Alignment.CenterVertically
+                            ) {
+                                Text(
+                                    text = "Enable Low Latency Present",
+                                    modifier = Modifier.align(Alignment.CenterVertically)
+                                )
+                                Switch(checked = enableLowLatencyPresent.value, onCheckedChange = {
+                                    enableLowLatencyPresent.value = !enableLowLatencyPresent.value
+                                })
+                            }
+                            Row(
+                                modifier = Modifier
+                                    .fillMaxWidth()
+                                    .padding(8.dp),
+                                horizontalArrangement = Arrangement.SpaceBetween,
+                                verticalAlignment = Alignment.CenterVertically
+                            ) {
+                                Text(
+                                    text = "Enable Prerotation",
+                                    modifier = Modifier.align(Alignment.CenterVertically)
+                                )
+                                Switch(checked = enablePrerotation.value, onCheckedChange = {
+                                    enablePrerotation.value = !enablePrerotation.value
+                                })
+                            }
                             Row(
                                 modifier = Modifier
                                     .fillMaxWidth()
@@ -1146,6 +1182,8 @@ class SettingViews {
                         useSwitchLayout,
                         enableMotion,
                         enablePerformanceMode,
+                        enableLowLatencyPresent,
+                        enablePrerotation,
                         controllerStickSensitivity,
                         enableDebugLogs,
                         enableStubLogs,